@@ -15,6 +15,174 @@
 #include "emp/web/Animate.hpp" // Include the Animate class for animation functionality
 #include "emp/web/web.hpp"     // Include web utilities for creating web-based interfaces
 #include "emp/math/Random.hpp" // Include random number generation utilities
+#include "emp/web/JSWrap.hpp"  // Include JSWrap so JavaScript events can call back into C++
+
+#include "ThreadPool.hpp" // Include the thread pool that parallelizes each generation
+#include "CARules.hpp"    // Include the update rules shared by every stepper
+#include "CAVolume.hpp"   // Include the 3D volume engine
+#include "HalfFloat.hpp"  // Include the half-precision conversions
+#include "SparseGrid.hpp" // Include the sparse tiled storage
+#include "DedupGrid.hpp"  // Include the deduplicated tiled storage
+#include "SummedArea.hpp" // Include the summed-area table neighborhood sums
+#include "Termination.hpp" // Include the early-termination criteria
+#include "Spectrum.hpp"    // Include the background spectral analysis
+#include "CompressedHistory.hpp" // Include the compressed history ring
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <emscripten.h>      // EM_ASM, used to blit the pixel buffer onto the canvas
+#include <emscripten/heap.h> // Heap size queries for the memory headroom report
+#include <unistd.h>          // sbrk(), used to find the top of the allocated heap
+#include <pthread.h>
+
+// Grid dimensions and history depth can be overridden at compile time.
+// compile-run.sh sizes the initial WASM memory from these same values so
+// the heap never has to grow (and invalidate typed-array views) mid-run.
+#ifndef CA_GRID_W
+#define CA_GRID_W 100
+#endif
+#ifndef CA_GRID_H
+#define CA_GRID_H 100
+#endif
+// A depth above 1 switches to the 3D automaton: the volume is stepped
+// instead of the 2D grid, and the canvas shows one z-slice of it.
+#ifndef CA_GRID_D
+#define CA_GRID_D 1
+#endif
+#ifndef CA_HISTORY_FRAMES
+#define CA_HISTORY_FRAMES 0
+#endif
+// Megabytes for a compressed history ring of past generations, scrubbed
+// with the Rewind slider; 0 disables it. Frames are quantized to 8 bits and
+// stored as differences from the previous frame, with a keyframe every 32,
+// so the budget holds far more generations than CA_HISTORY_FRAMES would.
+// Applies to 2D runs without a worker.
+#ifndef CA_COMPRESSED_HISTORY_MB
+#define CA_COMPRESSED_HISTORY_MB 0
+#endif
+
+// When enabled, the canvas holds one pixel per cell and the browser scales it
+// up with `image-rendering: pixelated`; grid lines are drawn once on an overlay.
+#ifndef CA_PIXEL_RENDER
+#define CA_PIXEL_RENDER 0
+#endif
+
+// When enabled, the canvas is transferred to a simulation thread as an
+// OffscreenCanvas, so stepping and drawing both happen off the main thread.
+// Requires a pthreads build (-pthread) and implies the pixel render mode.
+#ifndef CA_WORKER
+#define CA_WORKER 0
+#endif
+
+// Side length, in cells, of the tiles that share one set of rule parameters
+// when spatially varying rules are enabled (1 = per cell). 0 disables the
+// parameter fields so every cell uses the global rules. Tiles are given
+// their rules by painting with Alt held. 2D only: the 3D volume always uses
+// the global rules.
+#ifndef CA_PARAM_TILE
+#define CA_PARAM_TILE 0
+#endif
+static_assert(CA_PARAM_TILE == 0 || CA_GRID_D == 1, "parameter fields (CA_PARAM_TILE) only apply to 2D grids");
+
+// How cells are updated: 0 = synchronous (every cell from the previous
+// generation, using a second buffer), 1 = random sweep and 2 = checkerboard,
+// both asynchronous and in place, so the second buffer is never allocated.
+#ifndef CA_UPDATE_MODE
+#define CA_UPDATE_MODE 0
+#endif
+
+// Stochastic updates: uniform noise in [-CA_NOISE_AMPLITUDE, CA_NOISE_AMPLITUDE]
+// added to each new state, and the chance CA_NOISE_SKIP that a cell keeps its
+// old state instead of updating. The random numbers are keyed by CA_NOISE_SEED,
+// the generation and the cell, so runs are reproducible with any thread count.
+// All zero (the default) keeps the update deterministic. Applies to 2D runs.
+#ifndef CA_NOISE_AMPLITUDE
+#define CA_NOISE_AMPLITUDE 0
+#endif
+#ifndef CA_NOISE_SKIP
+#define CA_NOISE_SKIP 0
+#endif
+#ifndef CA_NOISE_SEED
+#define CA_NOISE_SEED 0
+#endif
+
+// When enabled, the synchronous 2D stepper keeps the grid in half precision,
+// halving the memory traffic of each generation; `cells` becomes a float
+// copy that is decoded only when something needs to read it.
+#ifndef CA_HALF_STORAGE
+#define CA_HALF_STORAGE 0
+#endif
+// With half-precision storage, how often (in generations) to print how far
+// the live run has drifted from a full-precision copy stepped alongside it
+// (see TrackHalfAccuracy); 0 keeps no copy.
+#ifndef CA_HALF_REPORT
+#define CA_HALF_REPORT 0
+#endif
+
+// When enabled, the synchronous 2D stepper keeps the grid as sparse tiles
+// (empty, bitmask + packed values, or dense) for extremely sparse fields;
+// like half-precision storage, `cells` becomes a lazily decoded copy.
+#ifndef CA_SPARSE_STORAGE
+#define CA_SPARSE_STORAGE 0
+#endif
+
+// When enabled, the synchronous 2D stepper keeps the grid as shared tiles:
+// identical tiles (all-zero or repeating) are stored once, and each distinct
+// 3x3 block of tiles is stepped once, its result reused wherever and
+// whenever the block recurs. Results match the plain stepper exactly.
+#ifndef CA_DEDUP_STORAGE
+#define CA_DEDUP_STORAGE 0
+#endif
+
+// When enabled, the synchronous 2D stepper takes both neighborhood sums
+// from a summed-area table rebuilt every generation, four lookups each,
+// instead of adding up the 3x3 and 7x7 squares cell by cell.
+#ifndef CA_SAT_NEIGHBORHOOD
+#define CA_SAT_NEIGHBORHOOD 0
+#endif
+
+// When enabled, each generation's statistics are gathered while it is
+// computed and checked against early-termination criteria (extinction,
+// saturation, fixed point, short cycles, population band); a run that meets
+// one is stopped. Applies to 2D runs.
+#ifndef CA_EARLY_STOP
+#define CA_EARLY_STOP 0
+#endif
+
+// When nonzero, every this many generations a copy of the grid is handed to
+// a background thread that computes its radially averaged power spectrum and
+// spatial autocorrelation. A snapshot offered while the previous one is still
+// being analyzed is skipped, so stepping never waits. Applies to 2D runs and
+// requires a pthreads build (-pthread).
+#ifndef CA_SPECTRUM_INTERVAL
+#define CA_SPECTRUM_INTERVAL 0
+#endif
+
+// Number of threads used to compute each generation. Values above 1
+// require a pthreads build (-pthread).
+#ifndef CA_THREADS
+#define CA_THREADS 1
+#endif
+
+// Generations per second to keep simulating while the canvas can't be seen
+// (tab hidden or scrolled out of view). 0 pauses the simulation instead.
+#ifndef CA_HIDDEN_STEP_HZ
+#define CA_HIDDEN_STEP_HZ 0
+#endif
+
+#if CA_WORKER
+#include <emscripten/threading.h>
+#undef CA_PIXEL_RENDER
+#define CA_PIXEL_RENDER 1
+#endif
 
 emp::web::Document doc{"target"};
 
@@ -22,17 +190,163 @@ class CAAnimator : public emp::web::Animate {
 
     // Define constants for the size of each cell and the grid dimensions
     const int cellSize = 5; // Size of each cell in pixels
-    const int num_h_boxes = 100; // Number of cells in the grid's height
-    const int num_w_boxes = 100; // Number of cells in the grid's width
+    const int num_h_boxes = CA_GRID_H; // Number of cells in the grid's height
+    const int num_w_boxes = CA_GRID_W; // Number of cells in the grid's width
     const double width{double(num_w_boxes) * cellSize}; // Total width of the canvas
     const double height{double(num_h_boxes) * cellSize}; // Total height of the canvas
     const int startCells = int((num_h_boxes * num_w_boxes) / 100); // Define the number of initial cells to populate (1% of the grid)
+    const int historyFrames = CA_HISTORY_FRAMES; // Number of past generations kept for rewind/replay
+    const bool pixelRender = CA_PIXEL_RENDER; // Draw one pixel per cell and let CSS scale the canvas
+
+    // How a generation is computed; see CA_UPDATE_MODE
+    enum class UpdateMode { Synchronous = 0, RandomSweep = 1, Checkerboard = 2 };
+    const UpdateMode updateMode = UpdateMode(CA_UPDATE_MODE);
+
+    // Flat grids storing the state of each cell, indexed by Index(x, y).
+    // Both buffers are allocated once up front and swapped every generation;
+    // the asynchronous update modes work in place and leave nextCells empty.
+    std::vector<float> cells;
+    std::vector<float> nextCells;
+
+    // Half-precision storage only: the grid the stepper reads and writes, and
+    // whether `cells` is behind it and must be decoded before use
+    const bool halfStorage = CA_HALF_STORAGE && CA_GRID_D == 1 && CA_UPDATE_MODE == 0;
+    std::vector<uint16_t> halfCells;
+    std::vector<uint16_t> nextHalfCells;
+    // With CA_HALF_REPORT, the full-precision copy of the live run and its next generation
+    std::vector<float> halfReference;
+    std::vector<float> halfReferenceNext;
+
+    // Sparse storage only: the tiled grid the stepper reads and writes
+    // (noise can bring empty regions to life, which sparse stepping would skip, so noisy runs stay dense)
+    const bool sparseStorage = CA_SPARSE_STORAGE && !halfStorage && CA_GRID_D == 1 && CA_UPDATE_MODE == 0
+                               && CA_NOISE_AMPLITUDE == 0 && CA_NOISE_SKIP == 0;
+    std::unique_ptr<SparseGrid> sparse;
+
+    // Deduplicated storage only: the shared tiles the stepper reads and writes
+    const bool dedupStorage = CA_DEDUP_STORAGE && !halfStorage && !sparseStorage && CA_GRID_D == 1 && CA_UPDATE_MODE == 0;
+    std::unique_ptr<DedupGrid> dedup;
+
+    // Summed-area table only: the prefix sums of the current generation
+    const bool satNeighborhood = CA_SAT_NEIGHBORHOOD && !halfStorage && !sparseStorage && !dedupStorage && CA_GRID_D == 1 && CA_UPDATE_MODE == 0;
+    std::unique_ptr<SummedAreaTable> sat;
+
+    bool cellsStale = false; // `cells` is behind half-precision, sparse or deduplicated storage
+
+    // Early stopping only: the criteria, the statistics of the generation being
+    // computed (merged from every thread) and why the run last stopped early
+    const bool earlyStop = CA_EARLY_STOP && CA_GRID_D == 1;
+    TerminationMonitor termination;
+    std::mutex statsMutex;
+    GridStats stepStats;
+    bool statsFused = false; // The stepper filled stepStats itself this generation
+    std::atomic<TerminationReason> stopReason{TerminationReason::None};
+    std::atomic<bool> rearmPending{false}; // The monitor should forget the run before its next check
+
+    // Spectral analysis only: the background analyzer, how many of its results
+    // have been shown, and where the newest one is reported
+    const size_t spectrumInterval = CA_GRID_D == 1 ? CA_SPECTRUM_INTERVAL : 0;
+    std::unique_ptr<SpectralAnalyzer> spectrum;
+    size_t spectrumSeen = 0;
+    emp::web::Text spectrumText{"spectrum"};
+
+    // Ring buffer of the last historyFrames generations, also allocated up front
+    std::vector<float> history;
+
+    // The Rewind slider scrubs the history ring when there is one, where a
+    // past generation can be edited and replayed, or else the compressed history
+    const bool historyRewind = CA_HISTORY_FRAMES > 0 && CA_GRID_D == 1 && !CA_WORKER;
+    const bool compressedHistoryOn = CA_COMPRESSED_HISTORY_MB > 0 && CA_GRID_D == 1 && !CA_WORKER;
+    std::unique_ptr<CompressedHistory> compressedHistory;
+
+    // Rewinding only: the past generation being shown, which one it is and
+    // whether the canvas shows it instead of the current one
+    std::vector<float> scrubFrame;
+    size_t scrubGeneration = 0;
+    bool scrubbing = false;
+    std::atomic<size_t> generation{0}; // Number of generations computed so far
+
+    /**
+     * @brief The tunable parameters of the update rules.
+     */
+    struct RuleParams {
+        double birth = 0.275;    // Dead cells come alive at or above this neighbor average
+        double survival = 0.8;   // Live cells die above this neighbor average
+        float nearWeight = 0.5f; // Weight of the 3x3 neighborhood average
+        float farWeight = 0.5f;  // Weight of the 7x7 neighborhood average
+    };
+    RuleParams rules; // Used everywhere unless parameter fields are enabled
+
+    /**
+     * @brief Settings for the optional stochastic update; all zero means deterministic.
+     */
+    struct NoiseParams {
+        float amplitude = 0;       // Uniform noise in [-amplitude, amplitude] added to each new state
+        float skipProbability = 0; // Chance that a cell keeps its old state instead of updating
+        uint64_t seed = 0;         // Seed of the counter-based random numbers
+    };
+    NoiseParams noise{float(CA_NOISE_AMPLITUDE), float(CA_NOISE_SKIP), uint64_t(CA_NOISE_SEED)};
 
-    // 2D vector to store the state of each cell in the grid
-    std::vector<std::vector<float>> cells;
+    // Optional per-tile rule parameters, one plane per parameter so the
+    // stepping loop reads each as a plain array (empty when disabled)
+    const int paramTile = CA_PARAM_TILE;
+    int paramTilesW = 0;
+    int paramTilesH = 0;
+    std::vector<float> birthField;
+    std::vector<float> survivalField;
+    std::vector<float> nearWeightField;
+    std::vector<float> farWeightField;
+    RuleParams brushRules; // Given to the tiles painted with Alt held
 
-    // Create a canvas for drawing the grid
-    emp::web::Canvas canvas{width, height, "canvas"};
+    // Threads that share the work of computing each generation
+    ThreadPool pool{CA_THREADS};
+
+    // 3D mode only: the volume being simulated and the z-slice on display
+    std::unique_ptr<CAVolume> volume;
+    std::atomic<int> sliceZ{0};
+
+    // Run to N: the target generation, and the controls for reaching it without drawing
+    std::atomic<size_t> runTarget{0};
+    std::string runToValue = "1000";
+    bool resumeAfterRun = false; // Whether the animation was running when the run started
+    emp::web::Text progressText{"progress"};
+
+    // Create a canvas for drawing the grid; in pixel mode its backing store is exactly grid-sized
+    emp::web::Canvas canvas{pixelRender ? double(num_w_boxes) : width, pixelRender ? double(num_h_boxes) : height, "canvas"};
+
+    // Pixel mode only: static grid lines layered over the scaled canvas, and the
+    // RGBA frame buffer (one uint32 per cell, row-major) blitted with putImageData
+    emp::web::Div view{"view"};
+    emp::web::Canvas gridOverlay{width, height, "grid-overlay"};
+    std::vector<uint32_t> pixels;
+    uint32_t palette[256]; // RGBA color for each quantized cell state
+
+    // Worker mode only: the simulation thread and the flags the buttons use to drive it
+    const bool useWorker = CA_WORKER;
+    pthread_t workerThread;
+    std::atomic<bool> workerRunning{false}; // Toggle: step continuously
+    std::atomic<bool> workerStep{false};    // Step: advance exactly one generation
+
+    // Whether the canvas can currently be seen, as reported by the browser
+    std::atomic<bool> pageVisible{true};    // The tab is in the foreground
+    std::atomic<bool> canvasOnScreen{true}; // The canvas is scrolled into view
+    std::atomic<bool> renderPending{false}; // Generations were computed while hidden
+    const double hiddenStepHz = CA_HIDDEN_STEP_HZ;
+    double lastHiddenStep = 0; // Time of the last generation computed while hidden, in ms
+
+    // Cell painting: edits made with the mouse, queued for the worker in worker mode
+    struct PaintOp {
+        int x;
+        int y;
+        float value;
+        bool tileRules = false; // Sets the rules of the cell's tile to `params` instead
+        RuleParams params;
+    };
+    std::mutex paintMutex;
+    std::vector<PaintOp> pendingPaint;
+
+    // Text area reporting how much of the fixed WASM heap is still free
+    emp::web::Text memoryText{"memory"};
 
     public:
 
@@ -41,43 +355,223 @@ class CAAnimator : public emp::web::Animate {
         // Initialize a random number generator with a fixed seed for reproducibility
         emp::Random random_gen(444);
 
-        // Resize the cells grid to match the number of boxes
-        cells.resize(num_w_boxes, std::vector<float>(num_h_boxes, 0));
+        // Reserve every simulation buffer before the first frame so that
+        // nothing allocates while the animation is running
+        const size_t cellCount = size_t(num_w_boxes) * num_h_boxes;
+        cells.assign(cellCount, 0);
+        if (halfStorage) {
+            halfCells.assign(cellCount, 0);
+            nextHalfCells.assign(cellCount, 0);
+            if (CA_HALF_REPORT > 0) {
+                halfReference.assign(cellCount, 0);
+                halfReferenceNext.assign(cellCount, 0);
+                std::cout << "generation,max_abs_error,mean_abs_error,live_mismatches" << std::endl;
+            }
+        } else if (sparseStorage) {
+            sparse = std::make_unique<SparseGrid>(num_w_boxes, num_h_boxes, pool);
+        } else if (dedupStorage) {
+            dedup = std::make_unique<DedupGrid>(num_w_boxes, num_h_boxes, pool);
+        } else if (updateMode == UpdateMode::Synchronous) {
+            nextCells.assign(cellCount, 0);
+            if (satNeighborhood) {
+                sat = std::make_unique<SummedAreaTable>(num_w_boxes, num_h_boxes, 3);
+            }
+        }
+        history.assign(cellCount * historyFrames, 0);
+        if (compressedHistoryOn) {
+            compressedHistory = std::make_unique<CompressedHistory>(cellCount, size_t(CA_COMPRESSED_HISTORY_MB) << 20, 32);
+        }
+        if (historyRewind || compressedHistoryOn) {
+            scrubFrame.assign(cellCount, 0);
+        }
+        if (pixelRender) {
+            pixels.assign(cellCount, 0);
+            BuildPalette();
+        }
+        pendingPaint.reserve(1024);
+        if (earlyStop) {
+            termination.SetCriteria(DefaultTerminationCriteria());
+        }
+        if (spectrumInterval > 0) {
+            spectrum = std::make_unique<SpectralAnalyzer>(num_w_boxes, num_h_boxes);
+        }
+        if (paramTile > 0) {
+            // Round up so partial tiles at the edges get their own parameters
+            paramTilesW = (num_w_boxes + paramTile - 1) / paramTile;
+            paramTilesH = (num_h_boxes + paramTile - 1) / paramTile;
+            const size_t tileCount = size_t(paramTilesW) * paramTilesH;
+            birthField.assign(tileCount, float(rules.birth));
+            survivalField.assign(tileCount, float(rules.survival));
+            nearWeightField.assign(tileCount, rules.nearWeight);
+            farWeightField.assign(tileCount, rules.farWeight);
+        }
 
         DocSetup();
-        DrawCells();
+        // A canvas that already has a 2D context can't be transferred, so in
+        // worker mode the first frame is drawn by the worker instead
+        if (!useWorker) {
+            Render();
+        }
+        UpdateMemoryReport();
+        if (spectrum) {
+            emscripten_async_call(&CAAnimator::PollSpectrum, this, 250);
+        }
 
         // Populate the grid with a specified number of gliders
-        for (int r = 0; r < startCells; r++) {
-            MakeGlider(random_gen.GetInt(0, num_w_boxes), random_gen.GetInt(0, num_h_boxes));
+        if (CA_GRID_D > 1) {
+            // 3D mode: 1% of the volume's columns get an extruded glider
+            volume = std::make_unique<CAVolume>(num_w_boxes, num_h_boxes, CA_GRID_D, pool);
+            volume->SeedGliders(size_t(startCells) * CA_GRID_D, random_gen);
+            volume->CopySlice(sliceZ, cells);
+            PushCells();
+        } else {
+            // Stamp every glider in one batch, in random orientations, skipping overlaps
+            SeedGliders(startCells, random_gen, true);
+        }
+        RecordHistory();
+
+        if (useWorker) {
+            StartWorker();
         }
     }
 
         /**
-         * @brief Creates a "glider" pattern in the cellular automaton grid.
+         * @brief Where and how to stamp one glider, for StampGliders.
          * 
-         * This function modifies the `cells` grid to create a glider pattern starting
-         * at the specified (x, y) coordinates.
+         * Orientation 0 is a 2x2 body covering (x, y) to (x + 1, y + 1) with a
+         * 3-cell tail running diagonally from (x - 1, y - 1) to (x - 3, y - 3);
+         * 1 mirrors it horizontally, 2 vertically, and 3 both (a half turn),
+         * giving a glider moving towards each of the four diagonals.
+         */
+        struct GliderPlacement {
+            int x;
+            int y;
+            int orientation;
+        };
+
+        /**
+         * @brief Stamps many gliders into the grid at once.
          * 
-         * @param x The x-coordinate of the starting position for the glider.
-         * @param y The y-coordinate of the starting position for the glider.
+         * Each orientation's 7 cell offsets are precomputed as offsets into the
+         * flat grid, so a glider whose 5x5 bounding box doesn't cross the grid
+         * edge is written with plain index arithmetic; only gliders straddling
+         * the edge go through the wrapping Index() path.
          * 
-         * The function ensures that the coordinates wrap around the grid boundaries
-         * using modular arithmetic, allowing the glider to be placed seamlessly on a toroidal grid.
+         * @param placements The gliders to stamp, in order.
+         * @param avoidOverlap If true, a glider whose bounding box already contains
+         *        a live cell (from earlier seeding or this batch) is skipped.
+         * @return The number of gliders actually stamped.
          */
-        void MakeGlider (int x, int y) {
+        size_t StampGliders(const std::vector<GliderPlacement> & placements, bool avoidOverlap) {
+
+            // Glider cell offsets (dx, dy) in orientation 0; other orientations flip the signs
+            static constexpr int shape[7][2] = { {0, 0}, {1, 0}, {0, 1}, {1, 1}, {-1, -1}, {-2, -2}, {-3, -3} };
+
+            SyncCells();
+
+            // Precompute flat offsets for each orientation (x-major, so dx moves by a column)
+            const long colStride = num_h_boxes;
+            long flatOffsets[4][7];
+            for (int o = 0; o < 4; o++) {
+                for (int k = 0; k < 7; k++) {
+                    int dx = (o & 1) ? -shape[k][0] : shape[k][0];
+                    int dy = (o & 2) ? -shape[k][1] : shape[k][1];
+                    flatOffsets[o][k] = dx * colStride + dy;
+                }
+            }
+
+            size_t stamped = 0;
+            for (const GliderPlacement & p : placements) {
+                // Placements are normally already on the grid, so only wrap the ones that aren't
+                const int o = p.orientation & 3;
+                const int x = (p.x >= 0 && p.x < num_w_boxes) ? p.x : emp::Mod(p.x, num_w_boxes);
+                const int y = (p.y >= 0 && p.y < num_h_boxes) ? p.y : emp::Mod(p.y, num_h_boxes);
+
+                // Bounding box of the glider: 3 cells behind the anchor and 1 ahead on each axis
+                const int xLow = (o & 1) ? x - 1 : x - 3;
+                const int yLow = (o & 2) ? y - 1 : y - 3;
+                const bool inside = xLow >= 0 && yLow >= 0 && xLow + 5 <= num_w_boxes && yLow + 5 <= num_h_boxes;
+
+                if (inside) {
+                    // Fully inside the grid: no wrapping needed
+                    if (avoidOverlap) {
+                        bool live = false;
+                        for (int i = xLow; i < xLow + 5 && !live; i++) {
+                            const float * column = cells.data() + size_t(i) * num_h_boxes + yLow;
+                            live = std::any_of(column, column + 5, [](float state) { return state != 0; });
+                        }
+                        if (live) {
+                            continue;
+                        }
+                    }
+                    float * anchor = cells.data() + size_t(x) * num_h_boxes + y;
+                    for (int k = 0; k < 7; k++) {
+                        anchor[flatOffsets[o][k]] = 1;
+                    }
+                } else {
+                    if (avoidOverlap && BoxHasLiveCell(xLow, yLow, 5, 5)) {
+                        continue;
+                    }
+                    for (int k = 0; k < 7; k++) {
+                        int dx = (o & 1) ? -shape[k][0] : shape[k][0];
+                        int dy = (o & 2) ? -shape[k][1] : shape[k][1];
+                        cells[Index(x + dx, y + dy)] = 1;
+                    }
+                }
+                stamped++;
+            }
+            PushCells();
+            return stamped;
+        }
 
-            // Creating Glider Body
-            cells[emp::Mod(x, num_w_boxes)][emp::Mod(y, num_h_boxes)] = 1;
-            cells[emp::Mod(x + 1, num_w_boxes)][emp::Mod(y, num_h_boxes)] = 1;
-            cells[emp::Mod(x, num_w_boxes)][emp::Mod(y + 1, num_h_boxes)] = 1;
-            cells[emp::Mod(x + 1, num_w_boxes)][emp::Mod(y + 1, num_h_boxes)] = 1;
+        /**
+         * @brief Stamps randomly placed and oriented gliders into the grid.
+         * 
+         * @param count The number of gliders to attempt.
+         * @param random The random number generator to draw positions from.
+         * @param avoidOverlap If true, gliders that would overlap live cells are skipped.
+         * @return The number of gliders actually stamped.
+         */
+        size_t SeedGliders(size_t count, emp::Random & random, bool avoidOverlap) {
+            std::vector<GliderPlacement> placements(count);
+            for (GliderPlacement & p : placements) {
+                p.x = random.GetInt(0, num_w_boxes);
+                p.y = random.GetInt(0, num_h_boxes);
+                p.orientation = random.GetInt(0, 4);
+            }
+            return StampGliders(placements, avoidOverlap);
+        }
 
-            // Creating Glider Tail
-            cells[emp::Mod(x - 1, num_w_boxes)][emp::Mod(y - 1, num_h_boxes)] = 1;
-            cells[emp::Mod(x - 2, num_w_boxes)][emp::Mod(y - 2, num_h_boxes)] = 1;
-            cells[emp::Mod(x - 3, num_w_boxes)][emp::Mod(y - 3, num_h_boxes)] = 1;
+        /**
+         * @brief Checks whether any cell in a rectangle is alive.
+         * 
+         * @param x The x-coordinate of the rectangle's top-left corner (may wrap).
+         * @param y The y-coordinate of the rectangle's top-left corner (may wrap).
+         * @param w The width of the rectangle.
+         * @param h The height of the rectangle.
+         */
+        bool BoxHasLiveCell(int x, int y, int w, int h) const {
+            for (int i = x; i < x + w; i++) {
+                for (int j = y; j < y + h; j++) {
+                    if (cells[Index(i, j)] != 0) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
 
+        /**
+         * @brief Converts grid coordinates into an index into the flat cell buffers.
+         * 
+         * Coordinates wrap around the grid boundaries, so any (x, y) is valid.
+         * 
+         * @param x The x-coordinate of the cell.
+         * @param y The y-coordinate of the cell.
+         * @return The position of the cell in `cells`.
+         */
+        size_t Index(int x, int y) const {
+            return size_t(emp::Mod(x, num_w_boxes)) * num_h_boxes + emp::Mod(y, num_h_boxes);
         }
 
         /**
@@ -88,52 +582,366 @@ class CAAnimator : public emp::web::Animate {
          */
         void DocSetup() {
             // Add the canvas to the document
-            doc << canvas;
+            if (pixelRender) {
+                // Scale the grid-sized canvas up with nearest-neighbor filtering and
+                // stack the grid line overlay on top of it
+                canvas.SetCSS("width", emp::to_string(width) + "px", "height", emp::to_string(height) + "px",
+                              "image-rendering", "pixelated", "position", "absolute", "left", "0", "top", "0");
+                gridOverlay.SetCSS("position", "absolute", "left", "0", "top", "0", "pointer-events", "none");
+                view.SetCSS("position", "relative", "width", emp::to_string(width) + "px",
+                            "height", emp::to_string(height) + "px");
+                view << canvas << gridOverlay;
+                doc << view;
+                DrawGridLines();
+            } else {
+                doc << canvas;
+            }
 
             // Add toggle and step buttons to the document
-            doc << GetToggleButton("Toggle");
-            doc << GetStepButton("Step");
+            if (useWorker) {
+                // The worker owns the simulation loop, so the buttons only signal it
+                doc << emp::web::Button([this](){ workerRunning = !workerRunning; }, "Toggle", "toggle");
+                doc << emp::web::Button([this](){ workerStep = true; }, "Step", "step");
+            } else {
+                doc << GetToggleButton("Toggle");
+                doc << GetStepButton("Step");
+            }
+
+            // Add the run-to-generation control
+            doc << "<br>";
+            doc << emp::web::Input([this](std::string value){ runToValue = value; }, "number", "", "run-to")
+                       .Value(runToValue).Min(0);
+            doc << emp::web::Button([this](){ RunTo(std::stoull("0" + runToValue)); }, "Run to N", "run-to-button");
+            doc << " " << progressText;
+
+            // In 3D mode, add a slider choosing which z-slice is shown
+            if (CA_GRID_D > 1) {
+                doc << "<br>Slice z: ";
+                doc << emp::web::Input([this](std::string value){ ShowSlice(std::stoi("0" + value)); }, "range", "", "slice")
+                           .Min(0).Max(CA_GRID_D - 1).Value(0);
+            }
+
+            // With parameter fields, add the rules that painting with Alt held gives a tile
+            if (paramTile > 0) {
+                doc << "<br>Tile rules: birth ";
+                doc << RuleInput(brushRules.birth, "brush-birth");
+                doc << " survival " << RuleInput(brushRules.survival, "brush-survival");
+                doc << " near weight " << RuleInput(brushRules.nearWeight, "brush-near");
+                doc << " far weight " << RuleInput(brushRules.farWeight, "brush-far");
+            }
+
+            // Add the slider that scrubs back through the history
+            if (historyRewind || compressedHistory) {
+                doc << "<br>Rewind: ";
+                doc << emp::web::Input([this](std::string value){ Scrub(std::stoi("0" + value)); }, "range", "", "rewind")
+                           .Min(0).Max(100).Value(0);
+            }
+
+            // Add the memory report below the controls
+            doc << "<br>" << memoryText;
+            if (spectrumInterval > 0) {
+                doc << "<br>" << spectrumText;
+            }
+
+            WatchVisibility();
+            WatchPainting();
 
         }
 
         /**
-         * @brief Calculates the average state of the neighbors of a cell.
+         * @brief A number field editing one of the tile rule parameters.
          * 
-         * This function computes the average value of the states of the 8
-         * neighboring cells in the immediate vicinity of the cell at (x, y).
+         * @param target The parameter the field sets.
+         * @param id The HTML id of the field.
+         */
+        template <typename T>
+        emp::web::Input RuleInput(T & target, const std::string & id) {
+            emp::web::Input input([&target](std::string value){ target = T(std::atof(value.c_str())); }, "number", "", id);
+            input.Value(emp::to_string(target));
+            input.SetAttr("step", "any");
+            return input;
+        }
+
+        /**
+         * @brief Lets the user paint cells by clicking or dragging on the canvas.
+         * 
+         * Dragging with the primary button paints live cells; holding Shift
+         * erases them instead. With parameter fields, holding Alt gives the
+         * tiles dragged over the rules in the Tile rules fields.
+         */
+        void WatchPainting() {
+            uint32_t callback = emp::JSWrap(std::function<void(int, int, int)>([this](int x, int y, int mode) {
+                if (mode == 2) {
+                    PaintTileRules(x, y);
+                } else {
+                    PaintCell(x, y, mode == 1 ? 0.0f : 1.0f);
+                }
+            }), "", false);
+
+            EM_ASM({
+                var callback = $0;
+                var canvas = document.getElementById(UTF8ToString($1));
+                var w = $2;
+                var h = $3;
+                function paint(e) {
+                    if (!(e.buttons & 1)) {
+                        return;
+                    }
+                    // Map the pointer to a cell, whatever size the canvas is displayed at
+                    var rect = canvas.getBoundingClientRect();
+                    var x = Math.floor((e.clientX - rect.left) / rect.width * w);
+                    var y = Math.floor((e.clientY - rect.top) / rect.height * h);
+                    if (x >= 0 && x < w && y >= 0 && y < h) {
+                        emp.Callback(callback, x, y, e.altKey ? 2 : (e.shiftKey ? 1 : 0));
+                    }
+                }
+                canvas.addEventListener('pointerdown', paint);
+                canvas.addEventListener('pointermove', paint);
+            }, callback, canvas.GetID().c_str(), num_w_boxes, num_h_boxes);
+        }
+
+        /**
+         * @brief Sets a cell of the live grid from a paint event.
+         * 
+         * In worker mode the worker owns the grid, so the edit is queued and
+         * applied by the worker between generations.
          * 
          * @param x The x-coordinate of the cell.
          * @param y The y-coordinate of the cell.
-         * @param size The radius of the neighborhood to consider for averaging.
-         * @return The average state of the neighbors.
+         * @param value The new state of the cell.
+         */
+        void PaintCell(int x, int y, float value) {
+            if (useWorker) {
+                std::lock_guard<std::mutex> lock(paintMutex);
+                pendingPaint.push_back({x, y, value});
+                return;
+            }
+            if (scrubbing && historyRewind) {
+                // A recorded generation is shown: change it and replay up to the present
+                EditPastCell(scrubGeneration, x, y, value);
+                scrubFrame[Index(x, y)] = value;
+                CellsChanged(x, y, 1, 1);
+                return;
+            }
+            if (scrubbing) {
+                // Compressed frames can't be edited, so painting goes back to the current generation
+                LeaveScrub();
+                SetCell(x, y, value);
+                RenderWhenVisible();
+                return;
+            }
+            SetCell(x, y, value);
+            CellsChanged(x, y, 1, 1);
+        }
+
+        /**
+         * @brief Gives the parameter tile under a paint event the brush rules.
+         * 
+         * Queued for the worker in worker mode, like painted cells. Does
+         * nothing unless the build enables parameter fields.
+         * 
+         * @param x The x-coordinate of a cell in the tile.
+         * @param y The y-coordinate of a cell in the tile.
+         */
+        void PaintTileRules(int x, int y) {
+            if (paramTile == 0) {
+                return;
+            }
+            if (useWorker) {
+                std::lock_guard<std::mutex> lock(paintMutex);
+                PaintOp op{x, y, 0.0f};
+                op.tileRules = true;
+                op.params = brushRules;
+                pendingPaint.push_back(op);
+                return;
+            }
+            SetTileParams(x / paramTile, y / paramTile, brushRules);
+            RearmTermination();
+        }
+
+        /**
+         * @brief Applies paint events queued for the worker.
+         * 
+         * @return True if any cell changed.
+         */
+        bool ApplyPendingPaint() {
+            std::lock_guard<std::mutex> lock(paintMutex);
+            for (const PaintOp & op : pendingPaint) {
+                if (op.tileRules) {
+                    SetTileParams(op.x / paramTile, op.y / paramTile, op.params);
+                    RearmTermination();
+                } else {
+                    SetCell(op.x, op.y, op.value);
+                }
+            }
+            bool changed = !pendingPaint.empty();
+            pendingPaint.clear();
+            return changed;
+        }
+
+        /**
+         * @brief Writes one cell of the current generation.
+         * 
+         * The current history frame is kept in step so that rewinding and
+         * replaying see the edit.
          */
-        float NeighborsAvg(int x, int y, int size) {
+        void SetCell(int x, int y, float value) {
+            SyncCells();
+            RearmTermination();
+            cells[Index(x, y)] = value;
+            if (halfStorage) {
+                halfCells[Index(x, y)] = FloatToHalf(value);
+                if (!halfReference.empty()) {
+                    halfReference[Index(x, y)] = value;
+                }
+            }
+            if (sparse) {
+                sparse->Set(x, y, value);
+            }
+            if (dedup) {
+                dedup->Set(x, y, value);
+            }
+            if (volume) {
+                volume->Set(x, y, sliceZ, value);
+            }
+            if (historyFrames > 0) {
+                HistoryFrame(generation)[Index(x, y)] = value;
+            }
+        }
 
-            float neighborAvg = 0;
-            int gridLength = (2 * size) + 1;
-            int gridSize = (gridLength * gridLength) - 1;
-        
-            // Iterate through the neighborhood around the cell
-            for (int i = x - size; i <= x + size; i++) {
+        /**
+         * @brief Brings everything derived from the grid up to date after an edit.
+         * 
+         * Only the given rectangle is patched, so small edits stay cheap on
+         * large grids. Anything that caches information about the grid should
+         * update itself here.
+         * 
+         * @param x0 The left column of the edited rectangle.
+         * @param y0 The top row of the edited rectangle.
+         * @param w The width of the edited rectangle.
+         * @param h The height of the edited rectangle.
+         */
+        void CellsChanged(int x0, int y0, int w, int h) {
+            if (!IsVisible()) {
+                renderPending = true;
+            } else if (pixelRender) {
+                DrawPixelRegion(x0, y0, w, h);
+            } else {
+                for (int i = x0; i < x0 + w; i++) {
+                    for (int j = y0; j < y0 + h; j++) {
+                        float state = ShownCells()[Index(i, j)];
+                        canvas.Rect(i * cellSize, j * cellSize, cellSize, cellSize, emp::ColorHSV(340.0 * state, 1 * state, 1 * state), "black");
+                    }
+                }
+            }
+        }
 
-            for (int j = y - size; j <= y + size; j++) {
+        /**
+         * @brief Tracks whether the canvas can be seen.
+         * 
+         * Listens for the page being hidden and uses an IntersectionObserver to
+         * notice the canvas being scrolled out of view, so frames that nobody
+         * would see are never drawn.
+         */
+        void WatchVisibility() {
+            uint32_t callback = emp::JSWrap(std::function<void(int, int)>([this](int visible, int onScreen) {
+                SetVisibility(visible, onScreen);
+            }), "", false);
 
-                // Skip the cell itself
-                if (i == x && j == y) {
-                continue;
+            EM_ASM({
+                var callback = $0;
+                var onScreen = true;
+                function report() {
+                    emp.Callback(callback, document.visibilityState === 'visible' ? 1 : 0, onScreen ? 1 : 0);
                 }
-            
-                // Wrap around the grid boundaries
-                int wrapped_i = emp::Mod(i, num_w_boxes);
-                int wrapped_j = emp::Mod(j, num_h_boxes);
+                document.addEventListener('visibilitychange', report);
+                new IntersectionObserver(function(entries) {
+                    onScreen = entries[entries.length - 1].isIntersecting;
+                    report();
+                }).observe(document.getElementById(UTF8ToString($1)));
+            }, callback, canvas.GetID().c_str());
+        }
+
+        /**
+         * @brief Records a change in visibility reported by the browser.
+         * 
+         * When the canvas becomes visible again after generations were computed
+         * in the background, only the newest state is drawn.
+         * 
+         * @param visible Whether the page is in the foreground.
+         * @param onScreen Whether the canvas is scrolled into view.
+         */
+        void SetVisibility(bool visible, bool onScreen) {
+            pageVisible = visible;
+            canvasOnScreen = onScreen;
+
+            // The worker picks up renderPending itself on its next frame
+            if (IsVisible() && !useWorker && renderPending.exchange(false)) {
+                Render();
+            }
+        }
+
+        /**
+         * @brief Checks whether drawing a frame would be seen by anyone.
+         */
+        bool IsVisible() const {
+            return pageVisible && canvasOnScreen;
+        }
 
-                // Add the state of the neighbor to the total
-                neighborAvg += cells[wrapped_i][wrapped_j];
+        /**
+         * @brief Checks whether a background generation is due while hidden.
+         * 
+         * @return True at most hiddenStepHz times per second, never if it is 0.
+         */
+        bool HiddenStepDue() {
+            if (hiddenStepHz <= 0) {
+                return false;
             }
+            double now = emscripten_get_now();
+            if (now - lastHiddenStep < 1000.0 / hiddenStepHz) {
+                return false;
+            }
+            lastHiddenStep = now;
+            return true;
+        }
+
+        /**
+         * @brief Reports how much of the WASM heap is in use.
+         * 
+         * The web build is compiled with a fixed heap sized for the grid,
+         * so the headroom shown here is all the memory left for the run.
+         */
+        void UpdateMemoryReport() {
+            const double mb = 1024.0 * 1024.0;
+            const double heapSize = double(emscripten_get_heap_size());
+            const double heapUsed = double(reinterpret_cast<size_t>(sbrk(0)));
+
+            memoryText.Clear();
+            memoryText << "Heap: " << emp::to_string(heapUsed / mb) << " MB used of "
+                       << emp::to_string(heapSize / mb) << " MB ("
+                       << emp::to_string((heapSize - heapUsed) / mb) << " MB headroom)";
+            if (dedup && !useWorker) {
+                // The worker steps the tiles concurrently, so only report them without one
+                memoryText << ", " << emp::to_string(dedup->UniqueTiles()) << " distinct tiles of "
+                           << emp::to_string(dedup->TileCount());
             }
-        
-            // Return the average state of the all neighbors
-            return neighborAvg / gridSize;
+        }
+
+        /**
+         * @brief Calculates the average state of the neighbors of a cell.
+         * 
+         * This function computes the average value of the states of the 8
+         * neighboring cells in the immediate vicinity of the cell at (x, y).
+         * 
+         * @param grid The generation to read from (`cells` or a history frame).
+         * @param x The x-coordinate of the cell.
+         * @param y The y-coordinate of the cell.
+         * @param size The radius of the neighborhood to consider for averaging.
+         * @return The average state of the neighbors.
+         */
+        float NeighborsAvg(const float * grid, int x, int y, int size) const {
+            // Add up the neighbors in the shared order, wrapping around the grid boundaries
+            return NeighborhoodAvg(x, y, size, [this, grid](int i, int j) { return grid[Index(i, j)]; });
         }
 
         /**
@@ -151,97 +959,1166 @@ class CAAnimator : public emp::web::Animate {
                 for (int j = 0; j < num_h_boxes; j++) {
 
                     // Draw a rectangle for each cell with a color based on its state
-                    canvas.Rect(i * cellSize, j * cellSize, cellSize, cellSize, emp::ColorHSV(340.0 * cells[i][j], 1 * cells[i][j], 1 * cells[i][j]), "black");
+                    float state = ShownCells()[Index(i, j)];
+                    canvas.Rect(i * cellSize, j * cellSize, cellSize, cellSize, emp::ColorHSV(340.0 * state, 1 * state, 1 * state), "black");
                 }
             }
         }
 
         /**
-         * @brief Applies rules to determine the next state of a cell based on its current state and neighbors' average.
+         * @brief The grid the canvas draws: the current one, or a past one while scrubbing.
+         */
+        const float * ShownCells() const {
+            return scrubbing ? scrubFrame.data() : cells.data();
+        }
+
+        /**
+         * @brief Shows a past generation from the history ring or the compressed history.
          * 
-         * This function encapsulates the logic for updating a cell's state based on its current value
-         * and the average state of its neighbors.
+         * Pauses the animation; the current generation is untouched, and
+         * stepping again (or scrubbing back to 0) shows it once more. A
+         * generation from the history ring is exact, and painting on it
+         * edits it and replays forward (see EditPastCell).
          * 
-         * @param currentState The current state of the cell.
-         * @param allNeighborsAvg The average state of all neighbors.
-         * @return The updated state of the cell.
+         * @param percentBack How far back to go, as a percentage of the
+         * generations held: 0 is the current one, 100 the oldest.
          */
-        float ApplyRules(float currentState, float allNeighborsAvg) {
+        void Scrub(int percentBack) {
+            const size_t frames = historyRewind ? std::min<size_t>(historyFrames, generation + 1)
+                                                : (compressedHistory ? compressedHistory->Frames() : 0);
+            if (frames == 0) {
+                return;
+            }
+            if (GetActive()) {
+                Stop();
+            }
+            const size_t back = (frames - 1) * size_t(std::clamp(percentBack, 0, 100)) / 100;
+            progressText.Clear();
+            if (back == 0) {
+                scrubbing = false;
+            } else if (historyRewind) {
+                scrubGeneration = generation - back;
+                const float * frame = HistoryFrame(scrubGeneration);
+                std::copy(frame, frame + cells.size(), scrubFrame.begin());
+                scrubbing = true;
+                progressText << "Showing generation " << emp::to_string(scrubGeneration) << " of "
+                             << emp::to_string(size_t(generation)) << "; paint to change it and replay from there";
+            } else {
+                const size_t k = frames - 1 - back;
+                compressedHistory->Decode(k, scrubFrame.data());
+                scrubGeneration = compressedHistory->Generation(k);
+                scrubbing = true;
+                progressText << "Showing generation " << emp::to_string(scrubGeneration) << " of "
+                             << emp::to_string(size_t(generation)) << " (history holds "
+                             << emp::to_string(frames) << ")";
+            }
+            Render();
+        }
 
-            // Rules for live cells
-            if (currentState == 1) { 
-                if (allNeighborsAvg <= 0.8) {
-                    // Stay alive if the average state of neighbors is below a threshold
-                    return (1 + allNeighborsAvg) / 2;
-                } else {
-                    // Die if the average state of neighbors exceeds the threshold
-                    return 0;
+        /**
+         * @brief Goes back to showing the current generation and resets the Rewind slider.
+         * 
+         * The caller redraws the canvas, since every cell shown may change.
+         */
+        void LeaveScrub() {
+            if (!scrubbing) {
+                return;
+            }
+            scrubbing = false;
+            EM_ASM({
+                var slider = document.getElementById('rewind');
+                if (slider) {
+                    slider.value = 0;
                 }
-            } 
+            });
+        }
 
-            // Rules for dead cells
-            else { 
-                if (allNeighborsAvg >= 0.275) {
-                    // Become alive if the average state of neighbors is above a threshold
-                    return (1 + allNeighborsAvg) / 2;
-                } else {
-                    // Stay dead if the average state of neighbors is below the threshold
-                    return 0;
-                }
+        /**
+         * @brief Redraws the whole canvas now, or once it can be seen again.
+         */
+        void RenderWhenVisible() {
+            if (IsVisible()) {
+                Render();
+            } else {
+                renderPending = true;
             }
         }
 
         /**
-         * @brief Computes the next generation of the cellular automaton.
+         * @brief Switches the z-slice of the volume shown in 3D mode.
          * 
-         * This function calculates the state of each cell in the grid for the next
-         * generation based on the average states of its neighbors and specific rules
-         * for live and dead cells.
+         * @param z The slice to show.
+         */
+        void ShowSlice(int z) {
+            sliceZ = z;
+            if (useWorker) {
+                renderPending = true; // The worker owns the canvas and redraws
+            } else {
+                Render();
+            }
+        }
+
+        /**
+         * @brief Redraws the canvas using the configured render mode.
          * 
-         * @return A 2D vector representing the updated state of the grid.
+         * In 3D mode the current z-slice is copied out of the volume first.
          */
-        std::vector<std::vector<float>> NextGeneration() {
+        void Render() {
+            if (volume) {
+                volume->CopySlice(sliceZ, cells);
+            }
+            SyncCells();
+            if (pixelRender) {
+                DrawPixels();
+            } else {
+                // Clear the canvas to prepare for the next frame
+                canvas.Clear();
+                DrawCells();
+            }
+        }
 
-            // Create a new grid to store the next generation of cells
-            std::vector<std::vector<float>> newCells;
-            newCells.resize(num_w_boxes, std::vector<float>(num_h_boxes, 0));
+        /**
+         * @brief Draws the grid lines onto the overlay canvas.
+         * 
+         * In pixel mode the cell outlines never change, so they are drawn
+         * once here instead of being stroked around every cell each frame.
+         */
+        void DrawGridLines() {
+            for (int i = 0; i <= num_w_boxes; i++) {
+                gridOverlay.Line(i * cellSize, 0, i * cellSize, height, "black");
+            }
+            for (int j = 0; j <= num_h_boxes; j++) {
+                gridOverlay.Line(0, j * cellSize, width, j * cellSize, "black");
+            }
+        }
 
-            // Iterate through each cell in the grid
-            for (int i = 0; i < num_w_boxes; i++) {
+        /**
+         * @brief Precomputes the RGBA color of each quantized cell state.
+         * 
+         * Uses the same HSV gradient as DrawCells (hue 340 * state, saturation
+         * and value equal to state), so both render modes look alike.
+         */
+        void BuildPalette() {
+            for (int k = 0; k < 256; k++) {
+                double v = k / 255.0;
+                double h = std::fmod(340.0 * v, 360.0) / 60.0;
+                double c = v * v; // chroma = value * saturation
+                double x = c * (1 - std::fabs(std::fmod(h, 2.0) - 1));
+                double r = 0, g = 0, b = 0;
+                if (h < 1) { r = c; g = x; }
+                else if (h < 2) { r = x; g = c; }
+                else if (h < 3) { g = c; b = x; }
+                else if (h < 4) { g = x; b = c; }
+                else if (h < 5) { r = x; b = c; }
+                else { r = c; b = x; }
+                double m = v - c;
+                uint32_t R = uint32_t((r + m) * 255 + 0.5);
+                uint32_t G = uint32_t((g + m) * 255 + 0.5);
+                uint32_t B = uint32_t((b + m) * 255 + 0.5);
+                // Little-endian byte order in memory: R, G, B, A
+                palette[k] = R | (G << 8) | (B << 16) | (255u << 24);
+            }
+        }
 
-                for (int j = 0; j < num_h_boxes; j++) {
+        /**
+         * @brief Draws the current state of the cells as one pixel per cell.
+         * 
+         * Fills the RGBA frame buffer from the palette and hands it to the
+         * canvas in a single putImageData call; CSS does the scaling.
+         */
+        void DrawPixels() {
+            DrawPixelRegion(0, 0, num_w_boxes, num_h_boxes);
+        }
 
-                    // Calculate the average state of near and distant neighbors
-                    float nearNeighborAvg = NeighborsAvg(i, j, 1);
-                    float distNeighborAvg = NeighborsAvg(i, j, 3);
-                    float allNeighborsAvg = (nearNeighborAvg + distNeighborAvg) / 2;
+        /**
+         * @brief Redraws a rectangle of cells in pixel mode.
+         * 
+         * Only the pixels inside the rectangle are refreshed and uploaded.
+         * 
+         * @param x0 The left column of the rectangle.
+         * @param y0 The top row of the rectangle.
+         * @param w The width of the rectangle; x0 + w must not exceed the grid width.
+         * @param h The height of the rectangle; y0 + h must not exceed the grid height.
+         */
+        void DrawPixelRegion(int x0, int y0, int w, int h) {
 
-                    // Apply rules to determine the next state of the cell
-                    newCells[i][j] = ApplyRules(cells[i][j], allNeighborsAvg);
+            for (int j = y0; j < y0 + h; j++) {
+                uint32_t * row = pixels.data() + size_t(j) * num_w_boxes;
+                for (int i = x0; i < x0 + w; i++) {
+                    float state = std::clamp(ShownCells()[Index(i, j)], 0.0f, 1.0f);
+                    row[i] = palette[int(state * 255.0f + 0.5f)];
                 }
             }
-            // Return the updated grid for the next generation
-            return newCells;
-        }
 
+            EM_ASM({
+                var id = UTF8ToString($0);
+                // On the main thread the canvas is in the DOM; in the worker it is
+                // the OffscreenCanvas that was transferred when the thread started
+                var target = (typeof document !== 'undefined') ? document.getElementById(id)
+                                                                : GL.offscreenCanvases[id].offscreenCanvas;
+                var bytes = HEAPU8.subarray($1, $1 + $2 * $3 * 4);
+                // ImageData can't wrap shared memory, so threaded builds copy the frame
+                var data = (HEAPU8.buffer instanceof ArrayBuffer) ? new Uint8ClampedArray(bytes.buffer, $1, bytes.length)
+                                                                 : new Uint8ClampedArray(bytes);
+                target.getContext('2d').putImageData(new ImageData(data, $2, $3), 0, 0, $4, $5, $6, $7);
+            }, canvas.GetID().c_str(), pixels.data(), num_w_boxes, num_h_boxes, x0, y0, w, h);
+        }
 
         /**
-         * @brief Updates the animation frame.
+         * @brief Starts the simulation thread and hands it the canvas.
          * 
-         * This function is called on each frame of the animation. It clears the canvas,
-         * redraws the cells based on their current state, and computes the next generation
-         * of the cellular automaton.
+         * The canvas is transferred to the thread as an OffscreenCanvas, so
+         * after this call only the worker may draw to it.
          */
-        void DoFrame() {
+        void StartWorker() {
+#if CA_WORKER
+            const std::string selector = "#" + canvas.GetID();
+            pthread_attr_t attr;
+            pthread_attr_init(&attr);
+            emscripten_pthread_attr_settransferredcanvases(&attr, selector.c_str());
+            pthread_create(&workerThread, &attr, &CAAnimator::WorkerMain, this);
+            pthread_attr_destroy(&attr);
+#endif
+        }
 
-            // Clear the canvas to prepare for the next frame
-            canvas.Clear();
+        /**
+         * @brief Entry point of the simulation thread.
+         */
+        static void * WorkerMain(void * arg) {
+            static_cast<CAAnimator *>(arg)->WorkerLoop();
+            return nullptr;
+        }
 
-            // Draw the current state of the cells on the canvas
-            DrawCells();
-            
+        /**
+         * @brief Steps and draws the automaton on the simulation thread.
+         * 
+         * Runs for the lifetime of the page, pacing itself to about 60 frames
+         * per second and following the Toggle and Step buttons. While the
+         * canvas can't be seen nothing is drawn, and the simulation either
+         * pauses or runs at hiddenStepHz.
+         */
+        void WorkerLoop() {
+            const double frameMs = 1000.0 / 60.0;
+            const double idleMs = 100.0; // Polling interval while hidden and paused
+
+            Render();
+
+            while (true) {
+                double frameStart = emscripten_get_now();
+                double budgetMs = frameMs;
+
+                if (ApplyPendingPaint()) {
+                    renderPending = true;
+                }
+
+                // Fast-forward: step flat out without drawing, then draw the result once
+                if (generation < runTarget) {
+                    while (generation < runTarget && emscripten_get_now() - frameStart < frameMs) {
+                        NextGeneration();
+                    }
+                    renderPending = true;
+                    continue;
+                }
+
+                if (IsVisible()) {
+                    bool stepped = false;
+                    if (workerRunning || workerStep.exchange(false)) {
+                        NextGeneration();
+                        stepped = true;
+                    }
+                    // Draw only the newest state, including any computed while hidden
+                    if (stepped || renderPending.exchange(false)) {
+                        Render();
+                    }
+                } else if (hiddenStepHz > 0) {
+                    if (workerRunning || workerStep.exchange(false)) {
+                        NextGeneration();
+                        renderPending = true;
+                    }
+                    budgetMs = 1000.0 / hiddenStepHz;
+                } else {
+                    budgetMs = idleMs;
+                }
+
+                // Sleep off whatever is left of this frame
+                double elapsed = emscripten_get_now() - frameStart;
+                if (elapsed < budgetMs) {
+                    usleep(useconds_t((budgetMs - elapsed) * 1000));
+                }
+            }
+        }
+
+        /**
+         * @brief Computes the next state of every cell in a range of columns.
+         * 
+         * Reads only from `cells` and writes only the given columns of
+         * `nextCells`, so disjoint ranges can be computed in parallel.
+         * 
+         * @param begin The first column to compute.
+         * @param end One past the last column to compute.
+         * @param gen The generation being computed, which keys the noise.
+         */
+        void StepColumns(int begin, int end, size_t gen) {
+
+            GridStats stats;
+
+            // Iterate through each cell in the given columns, a run of rows sharing rules at a time
+            for (int i = begin; i < end; i++) {
+
+                for (int run = 0, runEnd; run < num_h_boxes; run = runEnd) {
+                    runEnd = RulesRunEnd(run);
+                    const RuleParams cellRules = RulesAt(i, run);
+                    for (int j = run; j < runEnd; j++) {
+                        const size_t index = size_t(i) * num_h_boxes + j;
+                        nextCells[index] = NextState(cells.data(), i, j, cellRules, index, gen);
+                        if (earlyStop) {
+                            stats.Add(index, cells[index], nextCells[index]);
+                        }
+                    }
+                }
+            }
+            MergeStats(stats);
+        }
+
+        /**
+         * @brief Like StepColumns, but with both neighborhood sums read from the summed-area table.
+         * 
+         * The table must already hold the prefix sums of `cells`.
+         * 
+         * @param begin The first column to compute.
+         * @param end One past the last column to compute.
+         * @param gen The generation being computed, which keys the noise.
+         */
+        void StepColumnsSAT(int begin, int end, size_t gen) {
+
+            GridStats stats;
+
+            for (int i = begin; i < end; i++) {
+
+                for (int run = 0, runEnd; run < num_h_boxes; run = runEnd) {
+                    runEnd = RulesRunEnd(run);
+                    const RuleParams cellRules = RulesAt(i, run);
+                    for (int j = run; j < runEnd; j++) {
+                        const size_t index = size_t(i) * num_h_boxes + j;
+                        const float self = cells[index];
+
+                        // The squares include the cell itself, which isn't its own neighbor
+                        float nearNeighborAvg = float((sat->BoxSum(i, j, 1) - self) / 8);
+                        float distNeighborAvg = float((sat->BoxSum(i, j, 3) - self) / 48);
+
+                        nextCells[index] = CombineState(self, nearNeighborAvg, distNeighborAvg, cellRules, index, gen);
+                        if (earlyStop) {
+                            stats.Add(index, self, nextCells[index]);
+                        }
+                    }
+                }
+            }
+            MergeStats(stats);
+        }
+
+        /**
+         * @brief Computes the next state of a single cell.
+         * 
+         * Coordinates wrap around the grid boundaries, so any (x, y) is valid.
+         * 
+         * @param grid The generation to read from.
+         * @param x The x-coordinate of the cell.
+         * @param y The y-coordinate of the cell.
+         * @param gen The generation being computed, which keys the noise.
+         * @return The state of the cell in the following generation.
+         */
+        float NextState(const float * grid, int x, int y, size_t gen) const {
+            x = emp::Mod(x, num_w_boxes);
+            y = emp::Mod(y, num_h_boxes);
+            return NextState(grid, x, y, RulesAt(x, y), size_t(x) * num_h_boxes + y, gen);
+        }
+
+        /**
+         * @brief Computes the next state of a cell whose rules and index the caller already has.
+         * 
+         * @param grid The generation to read from.
+         * @param x The x-coordinate of the cell, within the grid.
+         * @param y The y-coordinate of the cell, within the grid.
+         * @param cellRules The rules at the cell, from RulesAt.
+         * @param cell The index of the cell.
+         * @param gen The generation being computed, which keys the noise.
+         * @return The state of the cell in the following generation.
+         */
+        float NextState(const float * grid, int x, int y, const RuleParams & cellRules, size_t cell, size_t gen) const {
+
+            // Calculate the average state of near and distant neighbors
+            float nearNeighborAvg = NeighborsAvg(grid, x, y, 1);
+            float distNeighborAvg = NeighborsAvg(grid, x, y, 3);
+
+            return CombineState(grid[cell], nearNeighborAvg, distNeighborAvg, cellRules, cell, gen);
+        }
+
+        /**
+         * @brief The rule parameters at a cell: its tile's with parameter fields, else the global ones.
+         * 
+         * @param x The x-coordinate of the cell, within the grid.
+         * @param y The y-coordinate of the cell, within the grid.
+         */
+        RuleParams RulesAt(int x, int y) const {
+            if (paramTile == 0) {
+                return rules;
+            }
+            const size_t tile = size_t(x / paramTile) * paramTilesH + y / paramTile;
+            return RuleParams{birthField[tile], survivalField[tile], nearWeightField[tile], farWeightField[tile]};
+        }
+
+        /**
+         * @brief The end of the run of rows from `y` down that share one tile's rules.
+         * 
+         * Lets the stepping kernels look the rules up once per run instead of once per cell.
+         */
+        int RulesRunEnd(int y) const {
+            return paramTile == 0 ? num_h_boxes : std::min(num_h_boxes, (y / paramTile + 1) * paramTile);
+        }
+
+        /**
+         * @brief Turns a cell's neighborhood averages into its next state.
+         * 
+         * Shared by every stepping kernel, whatever way it computes the
+         * averages, so they all apply the same rules, parameters and noise.
+         * 
+         * @param state The current state of the cell.
+         * @param nearNeighborAvg The average of the 8 nearest neighbors.
+         * @param distNeighborAvg The average of the 48 neighbors within distance 3.
+         * @param cellRules The rules at the cell, from RulesAt.
+         * @param cell The index of the cell.
+         * @param gen The generation being computed, which keys the noise.
+         * @return The state of the cell in the following generation.
+         */
+        float CombineState(float state, float nearNeighborAvg, float distNeighborAvg,
+                           const RuleParams & cellRules, size_t cell, size_t gen) const {
+            float allNeighborsAvg = cellRules.nearWeight * nearNeighborAvg + cellRules.farWeight * distNeighborAvg;
+
+            // Apply rules to determine the next state of the cell
+            float newState = ApplyRules(state, allNeighborsAvg, cellRules.birth, cellRules.survival);
+
+            if (noise.amplitude > 0 || noise.skipProbability > 0) {
+                newState = ApplyNoise(state, newState, gen, cell);
+            }
+            return newState;
+        }
+
+        /**
+         * @brief Computes the next state of a range of columns from half-precision storage.
+         * 
+         * Each thread keeps the 7 columns around the current one decoded to
+         * floats, padded with 3 wrapped rows at either end, along with their
+         * vertical 3- and 7-cell sums. Moving to the next column decodes just
+         * one new column, and each cell's neighborhood sums take 3 and 7
+         * additions. The result is rounded back to half precision.
+         * 
+         * @param begin The first column to compute.
+         * @param end One past the last column to compute.
+         * @param gen The generation being computed, which keys the noise.
+         */
+        void StepColumnsHalf(int begin, int end, size_t gen) {
+            const int H = num_h_boxes;
+            const size_t padded = size_t(H) + 6;
+            GridStats stats;
+
+            // Per-thread scratch, sized on first use and reused every generation
+            thread_local std::vector<float> window;
+            thread_local std::vector<float> sums3;
+            thread_local std::vector<float> sums7;
+            thread_local std::vector<float> newColumn;
+            window.resize(7 * padded);
+            sums3.resize(7 * size_t(H));
+            sums7.resize(7 * size_t(H));
+            newColumn.resize(H);
+
+            // Decodes a column into the window slot it maps to, with its vertical sums
+            auto load = [&](int column) {
+                const size_t slot = size_t(emp::Mod(column, 7));
+                float * w = window.data() + slot * padded;
+                HalfToFloatRow(halfCells.data() + size_t(emp::Mod(column, num_w_boxes)) * H, w + 3, H);
+                for (int k = 0; k < 3; k++) {
+                    w[k] = w[3 + emp::Mod(k - 3, H)];
+                    w[H + 3 + k] = w[3 + emp::Mod(k, H)];
+                }
+                float * s3 = sums3.data() + slot * H;
+                float * s7 = sums7.data() + slot * H;
+                for (int j = 0; j < H; j++) {
+                    s3[j] = w[j + 2] + w[j + 3] + w[j + 4];
+                    s7[j] = w[j] + w[j + 1] + w[j + 2] + w[j + 3] + w[j + 4] + w[j + 5] + w[j + 6];
+                }
+            };
+
+            for (int column = begin - 3; column <= begin + 3; column++) {
+                load(column);
+            }
+
+            for (int i = begin; i < end; i++) {
+                if (i > begin) {
+                    load(i + 3);
+                }
+                const float * self = window.data() + size_t(emp::Mod(i, 7)) * padded + 3;
+                const float * s3[3];
+                const float * s7[7];
+                for (int k = 0; k < 7; k++) {
+                    s7[k] = sums7.data() + size_t(emp::Mod(i + k - 3, 7)) * H;
+                }
+                for (int k = 0; k < 3; k++) {
+                    s3[k] = sums3.data() + size_t(emp::Mod(i + k - 1, 7)) * H;
+                }
+
+                for (int run = 0, runEnd; run < H; run = runEnd) {
+                    runEnd = RulesRunEnd(run);
+                    const RuleParams cellRules = RulesAt(i, run);
+                    for (int j = run; j < runEnd; j++) {
+                        float nearSum = s3[0][j] + s3[1][j] + s3[2][j] - self[j];
+                        float farSum = s7[0][j] + s7[1][j] + s7[2][j] + s7[3][j] + s7[4][j] + s7[5][j] + s7[6][j] - self[j];
+                        newColumn[j] = CombineState(self[j], nearSum / 8, farSum / 48, cellRules, size_t(i) * H + j, gen);
+                    }
+                }
+                FloatToHalfRow(newColumn.data(), nextHalfCells.data() + size_t(i) * H, H);
+                if (earlyStop) {
+                    // Measure the stored, rounded states so the hash matches the grid
+                    const uint16_t * stored = nextHalfCells.data() + size_t(i) * H;
+                    for (int j = 0; j < H; j++) {
+                        stats.Add(size_t(i) * H + j, self[j], HalfToFloat(stored[j]));
+                    }
+                }
+            }
+            MergeStats(stats);
+        }
+
+        /**
+         * @brief Copies the float grid into half-precision, sparse or deduplicated storage after it was edited.
+         */
+        void PushCells() {
+            if (halfStorage) {
+                FloatToHalfRow(cells.data(), halfCells.data(), cells.size());
+                if (!halfReference.empty()) {
+                    halfReference = cells;
+                }
+            } else if (sparse) {
+                sparse->LoadDense(cells);
+            } else if (dedup) {
+                dedup->LoadDense(cells);
+            }
+            cellsStale = false;
+            RearmTermination();
+        }
+
+        /**
+         * @brief Brings `cells` up to date with half-precision, sparse or deduplicated storage before it is read.
+         */
+        void SyncCells() {
+            if (!cellsStale) {
+                return;
+            }
+            if (halfStorage) {
+                pool.ParallelFor(0, num_w_boxes, [this](int begin, int end) {
+                    const size_t first = size_t(begin) * num_h_boxes;
+                    HalfToFloatRow(halfCells.data() + first, cells.data() + first, size_t(end - begin) * num_h_boxes);
+                });
+            } else if (sparse) {
+                sparse->StoreDense(cells);
+            } else if (dedup) {
+                dedup->StoreDense(cells);
+            }
+            cellsStale = false;
+        }
+
+        /**
+         * @brief Measures how far half-precision storage drifts from full precision over the live run.
+         * 
+         * Steps the float copy in `halfReference` to the generation the
+         * half-precision grid was just stepped to, and every CA_HALF_REPORT
+         * generations prints to the console the largest and mean absolute
+         * difference and how many cells disagree on being alive. The copy
+         * restarts from the live grid whenever the grid is edited or loaded,
+         * so the report covers the drift since then.
+         * 
+         * @param gen The generation both grids are now at.
+         */
+        void TrackHalfAccuracy(size_t gen) {
+            if (halfReference.empty()) {
+                return;
+            }
+            pool.ParallelFor(0, num_w_boxes, [this, gen](int begin, int end) {
+                for (int i = begin; i < end; i++) {
+                    for (int j = 0; j < num_h_boxes; j++) {
+                        halfReferenceNext[Index(i, j)] = NextState(halfReference.data(), i, j, gen);
+                    }
+                }
+            });
+            std::swap(halfReference, halfReferenceNext);
+
+            if (gen % size_t(std::max(CA_HALF_REPORT, 1)) == 0) {
+                SyncCells();
+                double maxError = 0;
+                double totalError = 0;
+                size_t mismatches = 0;
+                for (size_t k = 0; k < cells.size(); k++) {
+                    double error = std::fabs(double(cells[k]) - halfReference[k]);
+                    maxError = std::max(maxError, error);
+                    totalError += error;
+                    mismatches += (cells[k] > 0) != (halfReference[k] > 0);
+                }
+                std::cout << gen << "," << maxError << "," << totalError / cells.size() << "," << mismatches << std::endl;
+            }
+        }
+
+        /**
+         * @brief Mixes a seed, generation and cell index into 32 random bits.
+         * 
+         * A counter-based generator: the result depends only on its inputs, so
+         * every cell draws its own numbers without shared state. That keeps
+         * stochastic runs identical whatever the thread count or the order in
+         * which cells are computed, and replays reproduce the original run.
+         * The body is pure integer arithmetic, so loops over cells vectorize.
+         */
+        static uint32_t CounterRandom(uint64_t seed, uint64_t gen, uint64_t cell, uint64_t stream) {
+            // SplitMix64 finalizer over a combination of the counters
+            uint64_t z = seed + gen * 0x9E3779B97F4A7C15ull + cell * 0xC2B2AE3D27D4EB4Full + stream * 0x165667B19E3779F9ull;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            z = z ^ (z >> 31);
+            return uint32_t(z >> 32);
+        }
+
+        /**
+         * @brief Applies the stochastic part of the update to one cell.
+         * 
+         * With probability skipProbability the cell keeps its old state
+         * instead of updating, then uniform noise in [-amplitude, amplitude]
+         * is added and the result clamped to [0, 1].
+         * 
+         * @param oldState The state of the cell in the previous generation.
+         * @param newState The deterministic next state.
+         * @param gen The generation being computed.
+         * @param cell The index of the cell.
+         * @return The state after noise.
+         */
+        float ApplyNoise(float oldState, float newState, size_t gen, size_t cell) const {
+            const float toUnit = 1.0f / 4294967296.0f; // Maps 32 random bits to [0, 1)
+
+            if (noise.skipProbability > 0 && CounterRandom(noise.seed, gen, cell, 0) * toUnit < noise.skipProbability) {
+                newState = oldState;
+            }
+            if (noise.amplitude > 0) {
+                float r = CounterRandom(noise.seed, gen, cell, 1) * toUnit;
+                newState = std::clamp(newState + (2 * r - 1) * noise.amplitude, 0.0f, 1.0f);
+            }
+            return newState;
+        }
+
+        /**
+         * @brief Sets the rule parameters of one tile of the parameter fields.
+         * 
+         * Only available when the build enables parameter fields (CA_PARAM_TILE);
+         * otherwise the global `rules` apply everywhere and this does nothing.
+         * 
+         * @param tileX The column of the tile, in tiles.
+         * @param tileY The row of the tile, in tiles.
+         * @param params The parameters for every cell in the tile.
+         */
+        void SetTileParams(int tileX, int tileY, const RuleParams & params) {
+            if (paramTile == 0) {
+                return;
+            }
+            const size_t tile = size_t(emp::Mod(tileX, paramTilesW)) * paramTilesH + emp::Mod(tileY, paramTilesH);
+            birthField[tile] = float(params.birth);
+            survivalField[tile] = float(params.survival);
+            nearWeightField[tile] = params.nearWeight;
+            farWeightField[tile] = params.farWeight;
+        }
+
+        /**
+         * @brief Computes the next generation of the cellular automaton.
+         * 
+         * This function calculates the state of each cell in the grid for the next
+         * generation based on the average states of its neighbors and specific rules
+         * for live and dead cells. The result is written into the preallocated
+         * `nextCells` buffer, which is then swapped with `cells`. In the
+         * asynchronous update modes the grid is updated in place instead.
+         * In 3D mode the volume is stepped and `cells` holds the shown slice.
+         */
+        void NextGeneration() {
+
+            stepStats = GridStats();
+            statsFused = halfStorage || (!sparse && !dedup && !volume && updateMode == UpdateMode::Synchronous);
+
+            if (volume) {
+                volume->Step();
+                volume->CopySlice(sliceZ, cells);
+            } else {
+                StepGrid(generation + 1);
+                if (halfStorage) {
+                    TrackHalfAccuracy(generation + 1);
+                }
+            }
+            generation++;
+
+            RecordHistory();
+            if (earlyStop) {
+                CheckTermination();
+            }
+            if (spectrum && generation % spectrumInterval == 0) {
+                SyncCells();
+                spectrum->Offer(cells.data(), generation);
+            }
+        }
+
+        /**
+         * @brief Computes the next generation of the 2D grid in whatever storage the build uses.
+         * 
+         * Only the grid changes; counting generations, recording history and
+         * checking for termination are left to the caller, so replaying a
+         * past generation goes through exactly the same stepper.
+         * 
+         * @param gen The generation being computed, which keys the noise.
+         */
+        void StepGrid(size_t gen) {
+            if (halfStorage) {
+                pool.ParallelFor(0, num_w_boxes, [this, gen](int begin, int end) {
+                    StepColumnsHalf(begin, end, gen);
+                });
+                std::swap(halfCells, nextHalfCells);
+                cellsStale = true;
+            } else if (sparse) {
+                // Empty regions can only be skipped while no birth threshold lets them come alive
+                const bool emptyStaysEmpty = paramTile == 0 ? rules.birth > 0
+                    : std::all_of(birthField.begin(), birthField.end(), [](float birth) { return birth > 0; });
+                sparse->Step([this, gen](float self, float nearAvg, float distAvg, int x, int y) {
+                    return CombineState(self, nearAvg, distAvg, RulesAt(x, y), size_t(x) * num_h_boxes + y, gen);
+                }, emptyStaysEmpty);
+                cellsStale = true;
+            } else if (dedup) {
+                // Tiles can only share results while the rule is the same everywhere
+                const bool uniformRule = paramTile == 0 && noise.amplitude == 0 && noise.skipProbability == 0;
+                dedup->Step([this, gen](float self, float nearAvg, float distAvg, int x, int y) {
+                    return CombineState(self, nearAvg, distAvg, RulesAt(x, y), size_t(x) * num_h_boxes + y, gen);
+                }, uniformRule);
+                cellsStale = true;
+            } else if (updateMode == UpdateMode::Synchronous) {
+                if (sat) {
+                    sat->Build(cells.data(), pool);
+                }
+
+                // Split the columns of the grid between the threads of the pool
+                pool.ParallelFor(0, num_w_boxes, [this, gen](int begin, int end) {
+                    if (sat) {
+                        StepColumnsSAT(begin, end, gen);
+                    } else {
+                        StepColumns(begin, end, gen);
+                    }
+                });
+
+                // Make the new generation current without reallocating either buffer
+                std::swap(cells, nextCells);
+            } else {
+                UpdateInPlace(cells.data(), gen);
+            }
+        }
+
+        /**
+         * @brief Adds one thread's share of a generation's statistics.
+         */
+        void MergeStats(const GridStats & stats) {
+            if (!earlyStop) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(statsMutex);
+            stepStats.Merge(stats);
+        }
+
+        /**
+         * @brief Checks the generation just computed against the termination criteria.
+         * 
+         * The synchronous and half-precision steppers gather the statistics as
+         * they write the new generation. The other steppers don't see the old
+         * and new state of a cell together, so their grid is read once more
+         * here, and only an exact repeat counts as a fixed point.
+         * 
+         * Once a criterion is met the run stops, and no more checks are made
+         * until the grid is edited.
+         */
+        void CheckTermination() {
+            if (rearmPending.exchange(false)) {
+                termination.Reset();
+            }
+            if (stopReason != TerminationReason::None) {
+                return;
+            }
+            if (!statsFused) {
+                SyncCells();
+                pool.ParallelFor(0, num_w_boxes, [this](int begin, int end) {
+                    GridStats stats;
+                    stats.hasChange = false;
+                    for (size_t index = size_t(begin) * num_h_boxes; index < size_t(end) * num_h_boxes; index++) {
+                        stats.AddState(index, cells[index]);
+                    }
+                    MergeStats(stats);
+                });
+            }
+
+            const TerminationReason reason = termination.Check(stepStats, generation);
+            if (reason == TerminationReason::None) {
+                return;
+            }
+            stopReason = reason;
+
+            // End a Run to N where it is (RunSlice reports it), and stop continuous
+            // stepping; without a worker, DoFrame stops the animation and reports it
+            const bool runningTo = runTarget > generation;
+            runTarget = size_t(generation);
+            if (useWorker) {
+                workerRunning = false;
+#if CA_WORKER
+                if (!runningTo) {
+                    emscripten_async_run_in_main_runtime_thread(EM_FUNC_SIG_VI, (void *) &CAAnimator::ShowTermination, this);
+                }
+#endif
+            }
+        }
+
+        /**
+         * @brief Re-enables early stopping after the grid is edited or a new run starts.
+         * 
+         * The monitor itself is reset by the stepping thread before its next
+         * check, so this is safe to call from the page while a worker steps.
+         */
+        void RearmTermination() {
+            if (earlyStop) {
+                rearmPending = true;
+                stopReason = TerminationReason::None;
+            }
+        }
+
+        /**
+         * @brief Reports in the progress text why the run stopped early.
+         */
+        static void ShowTermination(void * arg) {
+            CAAnimator & self = *static_cast<CAAnimator *>(arg);
+            self.progressText.Clear();
+            self.progressText << "Stopped at generation " << emp::to_string(size_t(self.generation))
+                              << ": " << DescribeTermination(self.stopReason);
+        }
+
+        /**
+         * @brief Replaces the early-termination criteria; only used when early stopping is enabled.
+         * 
+         * Call it while nothing is stepping (before starting, or between runs without a worker).
+         */
+        void SetTermination(const TerminationCriteria & criteria) {
+            termination.SetCriteria(criteria);
+            stopReason = TerminationReason::None;
+        }
+
+        /**
+         * @brief Shows the newest spectral analysis result, then checks again in 250 ms.
+         * 
+         * Runs on the main thread whether or not a worker steps, so results
+         * appear while running, during a Run to N and in the background alike.
+         * Each result is also logged to the console as CSV rows (the radial
+         * power spectrum and the radial correlation) for offline analysis.
+         */
+        static void PollSpectrum(void * arg) {
+            CAAnimator & self = *static_cast<CAAnimator *>(arg);
+            SpectrumResult result;
+            if (self.spectrum->Latest(result, self.spectrumSeen)) {
+                self.spectrumText.Clear();
+                self.spectrumText << "Spectrum at generation " << emp::to_string(result.generation)
+                                  << ": correlation length " << emp::to_string(result.correlationLength)
+                                  << " cells, dominant wavelength " << emp::to_string(result.dominantWavelength) << " cells";
+
+                std::cout << "power," << result.generation;
+                for (double value : result.radialPower) {
+                    std::cout << "," << value;
+                }
+                std::cout << "\ncorrelation," << result.generation;
+                for (double value : result.radialCorrelation) {
+                    std::cout << "," << value;
+                }
+                std::cout << std::endl;
+            }
+            emscripten_async_call(&CAAnimator::PollSpectrum, arg, 250);
+        }
+
+        /**
+         * @brief Computes one asynchronous generation directly in a grid.
+         * 
+         * Random sweep updates as many randomly chosen cells as the grid has,
+         * one after another, each seeing every update made before it.
+         * 
+         * Checkerboard splits the grid into color classes whose cells are at
+         * least 4 apart on some axis, so no cell of a class lies in the 7x7
+         * neighborhood of another; each class can then be updated in parallel
+         * and the classes run one after another. Columns are colored x % 4,
+         * except that the columns left over when the width isn't a multiple
+         * of 4 each get a color of their own so the wrap-around seam stays
+         * safe; rows are colored the same way, giving at most 7 x 7 classes.
+         * 
+         * @param grid The grid to update.
+         * @param gen The generation being computed, which keys the random choices.
+         */
+        void UpdateInPlace(float * grid, size_t gen) {
+
+            if (updateMode == UpdateMode::RandomSweep) {
+                const size_t cellCount = cells.size();
+                for (size_t k = 0; k < cellCount; k++) {
+                    size_t cell = CounterRandom(noise.seed, gen, k, 2) % cellCount;
+                    int x = int(cell / num_h_boxes);
+                    int y = int(cell % num_h_boxes);
+                    grid[cell] = NextState(grid, x, y, gen);
+                }
+                return;
+            }
+
+            const int fullX = num_w_boxes / 4 * 4;
+            const int fullY = num_h_boxes / 4 * 4;
+            const int colorsX = 4 + (num_w_boxes - fullX);
+            const int colorsY = 4 + (num_h_boxes - fullY);
+
+            for (int colorX = 0; colorX < colorsX; colorX++) {
+                // Columns with this color: every 4th one in the main part, or one leftover column
+                const int firstX = (colorX < 4) ? colorX : fullX + colorX - 4;
+                const int strideX = (colorX < 4) ? 4 : num_w_boxes;
+                const int endX = (colorX < 4) ? fullX : firstX + 1;
+                const int countX = (endX - firstX + strideX - 1) / strideX;
+
+                for (int colorY = 0; colorY < colorsY; colorY++) {
+                    const int firstY = (colorY < 4) ? colorY : fullY + colorY - 4;
+                    const int strideY = (colorY < 4) ? 4 : num_h_boxes;
+                    const int endY = (colorY < 4) ? fullY : firstY + 1;
+
+                    // No cell of this class reads another, so the class runs in parallel
+                    pool.ParallelFor(0, countX, [&](int begin, int end) {
+                        for (int k = begin; k < end; k++) {
+                            int i = firstX + k * strideX;
+                            for (int j = firstY; j < endY; j += strideY) {
+                                grid[Index(i, j)] = NextState(grid, i, j, gen);
+                            }
+                        }
+                    });
+                }
+            }
+        }
+
+        /**
+         * @brief Copies the current generation into its slot of the history ring.
+         * 
+         * The compressed history gets it too. Its frames are never rewritten,
+         * so edits to the current generation show up from the next one on.
+         */
+        void RecordHistory() {
+            if (historyFrames > 0) {
+                SyncCells();
+                std::copy(cells.begin(), cells.end(), HistoryFrame(generation));
+            }
+            if (compressedHistory) {
+                SyncCells();
+                compressedHistory->Push(cells.data(), generation);
+            }
+        }
+
+        /**
+         * @brief Finds the history ring slot holding a given generation.
+         * 
+         * Only the last historyFrames generations are kept; older slots have
+         * been overwritten by newer generations.
+         */
+        float * HistoryFrame(size_t gen) {
+            return history.data() + (gen % historyFrames) * cells.size();
+        }
+
+        /**
+         * @brief Changes one cell of a past generation and replays forward from it.
+         * 
+         * Rewrites the recorded history as if the edit had happened at that
+         * generation, replaying through the same stepper as the live run so
+         * the new timeline is exactly what stepping would have produced.
+         * With the plain synchronous stepper a change can spread at most 3
+         * cells (the distant neighborhood radius) per generation, so each
+         * later generation only recomputes the square light cone around the
+         * edit from the previous, already corrected, frame; everything outside
+         * it is unchanged. Once the cone wraps all the way around the torus,
+         * whole frames are recomputed instead. Every other stepper (half
+         * precision, sparse or shared tiles, the summed-area table and the
+         * asynchronous modes) replays whole frames through the live storage.
+         * The animation must be paused while replaying.
+         * 
+         * @param gen The generation to edit; must still be in the history ring.
+         * @param x The x-coordinate of the cell to change.
+         * @param y The y-coordinate of the cell to change.
+         * @param value The new state of the cell.
+         * @return False if the generation is no longer (or not yet) in history.
+         */
+        bool EditPastCell(size_t gen, int x, int y, float value) {
+            const size_t current = generation;
+            if (historyFrames == 0 || volume || gen > current || current - gen >= size_t(historyFrames)) {
+                return false;
+            }
+            if (HistoryFrame(gen)[Index(x, y)] == value) {
+                return true; // Nothing changes, e.g. when a drag paints the same cell again
+            }
+
+            HistoryFrame(gen)[Index(x, y)] = value;
+
+            const bool lightCone = updateMode == UpdateMode::Synchronous && !halfStorage && !sparse && !dedup && !sat;
+            for (size_t g = gen + 1; g <= current; g++) {
+                const float * src = HistoryFrame(g - 1);
+                float * dst = HistoryFrame(g);
+
+                if (!lightCone) {
+                    // Step the previous frame with the live stepper; the present is restored below
+                    std::copy(src, src + cells.size(), cells.begin());
+                    PushCells();
+                    StepGrid(g);
+                    SyncCells();
+                    std::copy(cells.begin(), cells.end(), dst);
+                    continue;
+                }
+
+                // The cone's extent on each axis, clamped to the whole grid once it wraps
+                const size_t radius = 3 * (g - gen);
+                const int spanX = int(std::min<size_t>(2 * radius + 1, num_w_boxes));
+                const int spanY = int(std::min<size_t>(2 * radius + 1, num_h_boxes));
+                const int x0 = (spanX == num_w_boxes) ? 0 : x - int(radius);
+                const int y0 = (spanY == num_h_boxes) ? 0 : y - int(radius);
+
+                if (spanX == num_w_boxes && spanY == num_h_boxes) {
+                    // The cone covers the torus: recompute the whole frame
+                    pool.ParallelFor(0, num_w_boxes, [&](int begin, int end) {
+                        for (int i = begin; i < end; i++) {
+                            for (int j = 0; j < num_h_boxes; j++) {
+                                dst[Index(i, j)] = NextState(src, i, j, g);
+                            }
+                        }
+                    });
+                    continue;
+                }
+
+                pool.ParallelFor(0, spanX, [&](int begin, int end) {
+                    for (int i = x0 + begin; i < x0 + end; i++) {
+                        for (int j = y0; j < y0 + spanY; j++) {
+                            dst[Index(i, j)] = NextState(src, i, j, g);
+                        }
+                    }
+                });
+            }
+
+            // The replayed present becomes the live grid
+            std::copy(HistoryFrame(current), HistoryFrame(current) + cells.size(), cells.begin());
+            PushCells();
+
+            // The compressed history holds the timeline the edit replaced
+            if (compressedHistory) {
+                compressedHistory->Clear();
+                compressedHistory->Push(cells.data(), current);
+            }
+            return true;
+        }
+
+        /**
+         * @brief Fast-forwards the simulation to a given generation without drawing.
+         * 
+         * Generations are computed as fast as the thread pool allows, with the
+         * progress text refreshed periodically, and the grid is drawn once at
+         * the end. The animation is paused during the run and resumed after.
+         * 
+         * @param target The generation to stop at; ignored if already reached.
+         */
+        void RunTo(size_t target) {
+            if (target <= generation || runTarget > generation) {
+                return;
+            }
+            runTarget = target;
+            RearmTermination();
+            LeaveScrub(); // The final state is drawn when the run ends
+
+            if (!useWorker) {
+                resumeAfterRun = GetActive();
+                if (resumeAfterRun) {
+                    Stop();
+                }
+            }
+            // The worker steps towards runTarget on its own; the main thread
+            // only reports progress (and, without a worker, does the stepping)
+            emscripten_async_call(&CAAnimator::RunSlice, this, 0);
+        }
+
+        /**
+         * @brief Advances a fast-forward run by one time slice.
+         * 
+         * Steps for up to 50 ms (unless the worker is doing the stepping),
+         * updates the progress text, and schedules itself again until the
+         * target generation is reached, so the page stays responsive.
+         */
+        static void RunSlice(void * arg) {
+            CAAnimator & self = *static_cast<CAAnimator *>(arg);
+            const double sliceMs = 50.0;
+
+            if (!self.useWorker) {
+                double sliceStart = emscripten_get_now();
+                while (self.generation < self.runTarget && emscripten_get_now() - sliceStart < sliceMs) {
+                    self.NextGeneration();
+                }
+            }
+
+            self.progressText.Clear();
+            if (self.generation < self.runTarget) {
+                self.progressText << "Generation " << emp::to_string(size_t(self.generation)) << " / "
+                                  << emp::to_string(size_t(self.runTarget));
+                emscripten_async_call(&CAAnimator::RunSlice, arg, self.useWorker ? 100 : 0);
+                return;
+            }
+
+            // Done: draw the final state once
+            if (self.stopReason != TerminationReason::None) {
+                ShowTermination(arg);
+            } else {
+                self.progressText << "Reached generation " << emp::to_string(size_t(self.generation));
+            }
+            if (!self.useWorker) {
+                self.Render();
+                self.UpdateMemoryReport();
+                if (self.resumeAfterRun) {
+                    self.Start();
+                }
+            }
+        }
+
+        /**
+         * @brief Updates the animation frame.
+         * 
+         * This function is called on each frame of the animation. It clears the canvas,
+         * redraws the cells based on their current state, and computes the next generation
+         * of the cellular automaton. Drawing is skipped while the canvas is hidden.
+         */
+        void DoFrame() {
+            LeaveScrub();
+
+            // Draw the current state of the cells on the canvas, unless nobody can
+            // see it; then only keep stepping if a background rate is configured
+            if (IsVisible()) {
+                Render();
+                renderPending = false;
+            } else if (HiddenStepDue()) {
+                renderPending = true;
+            } else {
+                return;
+            }
+            
             // Compute the next generation of cells and update the grid
-            cells = NextGeneration();
+            const bool wasStopped = stopReason != TerminationReason::None;
+            NextGeneration();
+            if (!wasStopped && stopReason != TerminationReason::None) {
+                Stop();
+                ShowTermination(this);
+            }
+
+            // Refresh the memory report about once a second
+            if (generation % 60 == 0) {
+                UpdateMemoryReport();
+            }
 
         }
 };
@@ -0,0 +1,260 @@
+// File: CAEngine.hpp
+// Created on: October 18th, 2026
+
+// A headless version of the 2D automaton for native batch runs. It applies
+// the same rules as CAAnimator's synchronous stepper, through the same
+// shared functions, so a grid stepped here matches the page's.
+
+#ifndef CA_ENGINE_HPP
+#define CA_ENGINE_HPP
+
+#include "ThreadPool.hpp"  // Include the thread pool that parallelizes each generation
+#include "CARules.hpp"     // Include the update rules shared with the page
+#include "GridTiling.hpp"  // Include the coordinate wrapping shared by every grid
+#include "Termination.hpp" // Include the statistics gathered while stepping
+#include "Probes.hpp"      // Include the region probes sampled while stepping
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A toroidal 2D grid of continuous cells, stepped without any display.
+ *
+ * Cells are stored column by column, indexed x * height + y, as in CAAnimator.
+ */
+class CAEngine {
+
+    int w; // Grid width
+    int h; // Grid height
+
+    std::vector<float> cells;     // Current generation
+    std::vector<float> nextCells; // Next generation, swapped in after each step
+    size_t generation = 0;        // Number of generations computed so far
+
+    ThreadPool & pool;
+    std::mutex statsMutex;
+    ProbeSet probes; // Regions recorded every generation
+
+    public:
+
+    // Rule parameters, with the same meaning and defaults as CAAnimator's RuleParams
+    double birth = 0.275;
+    double survival = 0.8;
+    float nearWeight = 0.5f;
+    float farWeight = 0.5f;
+
+    // Neighborhood radii; the page always uses 1 and 3, coarse previews scale them down
+    int nearRadius = 1;
+    int farRadius = 3;
+
+    /**
+     * @brief Allocates both grid buffers.
+     *
+     * @param width Grid width.
+     * @param height Grid height.
+     * @param threads The pool used to parallelize each generation.
+     */
+    CAEngine(int width, int height, ThreadPool & threads) : w(width), h(height), pool(threads), probes(width, height) {
+        cells.assign(size_t(w) * h, 0);
+        nextCells.assign(size_t(w) * h, 0);
+    }
+
+    int GetWidth() const { return w; }
+    int GetHeight() const { return h; }
+    size_t GetGeneration() const { return generation; }
+    const std::vector<float> & GetCells() const { return cells; }
+
+    /**
+     * @brief The probes recorded by Step; add regions to it before stepping.
+     */
+    ProbeSet & Probes() { return probes; }
+    const ProbeSet & Probes() const { return probes; }
+
+    /**
+     * @brief Converts coordinates into an index into the flat grid, wrapping around.
+     */
+    size_t Index(int x, int y) const {
+        return size_t(Wrap(x, w)) * h + Wrap(y, h);
+    }
+
+    float Get(int x, int y) const { return cells[Index(x, y)]; }
+    void Set(int x, int y, float value) { cells[Index(x, y)] = value; }
+
+    /**
+     * @brief Stamps the page's glider in orientation 0 (see CAAnimator::GliderPlacement).
+     */
+    void MakeGlider(int x, int y) {
+        static constexpr int shape[7][2] = { {0, 0}, {1, 0}, {0, 1}, {1, 1}, {-1, -1}, {-2, -2}, {-3, -3} };
+        for (const auto & offset : shape) {
+            Set(x + offset[0], y + offset[1], 1);
+        }
+    }
+
+    /**
+     * @brief Clears the grid and seeds it with randomly placed gliders.
+     *
+     * Positions come from a SplitMix64 sequence, so a seed gives the same
+     * grid on every platform (though not the page's, which uses emp::Random).
+     *
+     * @param count The number of gliders to place.
+     * @param seed The seed of the positions.
+     */
+    void SeedGliders(size_t count, uint64_t seed) {
+        std::fill(cells.begin(), cells.end(), 0.0f);
+        generation = 0;
+        for (size_t k = 0; k < count; k++) {
+            const uint64_t x = SplitMix(seed);
+            const uint64_t y = SplitMix(seed);
+            MakeGlider(int(x % uint64_t(w)), int(y % uint64_t(h)));
+        }
+    }
+
+    /**
+     * @brief Computes the next generation.
+     *
+     * Each probed column is sampled as soon as it is written, so probes
+     * cost nothing for columns they don't touch.
+     *
+     * @param stats If given, receives the statistics of the new generation.
+     */
+    void Step(GridStats * stats = nullptr) {
+        if (stats) {
+            *stats = GridStats();
+        }
+        const bool probing = !probes.Empty();
+
+        pool.ParallelFor(0, w, [this, stats, probing](int begin, int end) {
+            GridStats local;
+            for (int i = begin; i < end; i++) {
+                for (int j = 0; j < h; j++) {
+                    const size_t index = size_t(i) * h + j;
+                    const float self = cells[index];
+                    float allNeighborsAvg = nearWeight * NeighborsAvg(i, j, nearRadius) + farWeight * NeighborsAvg(i, j, farRadius);
+                    nextCells[index] = ApplyRules(self, allNeighborsAvg, birth, survival);
+                    if (stats) {
+                        local.Add(index, self, nextCells[index]);
+                    }
+                }
+                if (probing) {
+                    probes.SampleColumn(i, nextCells.data() + size_t(i) * h);
+                }
+            }
+            if (stats) {
+                std::lock_guard<std::mutex> lock(statsMutex);
+                stats->Merge(local);
+            }
+        });
+
+        std::swap(cells, nextCells);
+        generation++;
+        if (probing) {
+            probes.EndGeneration(generation);
+        }
+    }
+
+    /**
+     * @brief Makes this engine a coarse copy of another, for cheap previews.
+     *
+     * Each factor x factor block of the fine grid (blocks at the edges may be
+     * smaller) is re-binarized into one cell: it is alive, with the mean of
+     * its nonzero states, when at least 35% of its cells are nonzero, and
+     * dead otherwise, so sparse gliders aren't smeared into faint states no
+     * rule ever produces. Both radii are divided by the factor and rounded;
+     * near stays at least 1 and far stays beyond near, so the two averages
+     * never cover the same cells. The rules and generation count are
+     * copied. This engine must be CoarseSize(fine size, factor) wide and high.
+     *
+     * @param fine The full-resolution engine.
+     * @param factor How many fine cells make up one coarse cell along each axis.
+     */
+    void LoadCoarse(const CAEngine & fine, int factor) {
+        const float liveFraction = 0.35f;
+
+        birth = fine.birth;
+        survival = fine.survival;
+        nearWeight = fine.nearWeight;
+        farWeight = fine.farWeight;
+        nearRadius = std::max(1, (fine.nearRadius + factor / 2) / factor);
+        farRadius = std::max(nearRadius + 1, (fine.farRadius + factor / 2) / factor);
+        generation = fine.generation;
+
+        for (int x = 0; x < w; x++) {
+            for (int y = 0; y < h; y++) {
+                const int xEnd = std::min(fine.w, (x + 1) * factor);
+                const int yEnd = std::min(fine.h, (y + 1) * factor);
+                int live = 0;
+                float liveSum = 0;
+                for (int i = x * factor; i < xEnd; i++) {
+                    for (int j = y * factor; j < yEnd; j++) {
+                        const float value = fine.cells[size_t(i) * fine.h + j];
+                        live += value != 0;
+                        liveSum += value;
+                    }
+                }
+                const int blockCells = (xEnd - x * factor) * (yEnd - y * factor);
+                cells[Index(x, y)] = live >= liveFraction * blockCells ? liveSum / live : 0;
+            }
+        }
+    }
+
+    /**
+     * @brief The number of coarse cells covering a number of fine ones.
+     */
+    static int CoarseSize(int fineSize, int factor) {
+        return (fineSize + factor - 1) / factor;
+    }
+
+    /**
+     * @brief Writes the generation number and grid in a native binary layout.
+     */
+    void Save(std::ostream & out) const {
+        const uint64_t header[3] = { uint64_t(w), uint64_t(h), uint64_t(generation) };
+        out.write(reinterpret_cast<const char *>(header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(cells.data()), std::streamsize(cells.size() * sizeof(float)));
+    }
+
+    /**
+     * @brief Reads a grid written by Save.
+     *
+     * @return False, leaving the engine unchanged, if the data is truncated or for another grid size.
+     */
+    bool Load(std::istream & in) {
+        uint64_t header[3];
+        if (!in.read(reinterpret_cast<char *>(header), sizeof(header)) ||
+            header[0] != uint64_t(w) || header[1] != uint64_t(h)) {
+            return false;
+        }
+        std::vector<float> loaded(cells.size());
+        if (!in.read(reinterpret_cast<char *>(loaded.data()), std::streamsize(loaded.size() * sizeof(float)))) {
+            return false;
+        }
+        cells.swap(loaded);
+        generation = size_t(header[2]);
+        return true;
+    }
+
+    private:
+
+    static uint64_t SplitMix(uint64_t & state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    /**
+     * @brief The average state of the cells within a radius, excluding the cell itself.
+     */
+    float NeighborsAvg(int x, int y, int size) const {
+        return NeighborhoodAvg(x, y, size, [this](int i, int j) {
+            return cells[size_t(Wrap(i, w)) * h + Wrap(j, h)];
+        });
+    }
+};
+
+#endif
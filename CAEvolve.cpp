@@ -0,0 +1,107 @@
+// File: CAEvolve.cpp
+// Created on: October 18th, 2026
+
+// Native tool that evolves the rule parameters toward an objective with the
+// genetic algorithm in Evolve.hpp, and prints the best genome of each round.
+//
+// Build: g++ -std=c++17 -O3 -march=native -pthread CAEvolve.cpp -o CAEvolve
+// Usage: ./CAEvolve [key=value ...]
+//   objective (moving or longevity), rounds, population, width, height,
+//   generations, seeds, threads, random_seed, cache (a file name, auto to name
+//   it after the objective and run setup, or empty to disable caching)
+
+#include "Evolve.hpp" // Include the genetic algorithm
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+
+int main(int argc, char * argv[]) {
+    std::map<std::string, std::string> options = {
+        {"objective", "moving"}, {"rounds", "20"}, {"population", "32"}, {"width", "128"}, {"height", "128"},
+        {"generations", "500"}, {"seeds", "3"}, {"random_seed", "361"}, {"cache", "auto"},
+        {"threads", std::to_string(std::max(1u, std::thread::hardware_concurrency()))},
+    };
+    for (int k = 1; k < argc; k++) {
+        const std::string argument = argv[k];
+        const size_t equals = argument.find('=');
+        if (equals == std::string::npos || !options.count(argument.substr(0, equals))) {
+            std::cerr << "Unknown option `" << argument << "`; options are key=value with keys:";
+            for (const auto & option : options) {
+                std::cerr << " " << option.first;
+            }
+            std::cerr << "\n";
+            return 1;
+        }
+        options[argument.substr(0, equals)] = argument.substr(equals + 1);
+    }
+
+    Objective objective;
+    if (options["objective"] == "moving") {
+        objective = MovingStructuresObjective;
+    } else if (options["objective"] == "longevity") {
+        objective = LongevityObjective;
+    } else {
+        std::cerr << "Unknown objective `" << options["objective"] << "`; use moving or longevity\n";
+        return 1;
+    }
+
+    EvolveSettings settings;
+    settings.width = std::stoi(options["width"]);
+    settings.height = std::stoi(options["height"]);
+    settings.generations = std::stoull(options["generations"]);
+    settings.populationSize = std::stoi(options["population"]);
+    settings.randomSeed = std::stoull(options["random_seed"]);
+    settings.seeds.clear();
+    for (uint64_t seed = 1; seed <= std::stoull(options["seeds"]); seed++) {
+        settings.seeds.push_back(seed);
+    }
+
+    ThreadPool pool(std::stoi(options["threads"]));
+    GeneticSearch search(settings, objective, pool);
+
+    // Evaluations from earlier sessions are only valid for the same objective
+    // and run setup: the cache file's header records them, the default file
+    // name is derived from them, and a cache written for another setup is refused
+    const std::string setup = search.CacheSetup(options["objective"]);
+    std::string cachePath = options["cache"];
+    if (cachePath == "auto") {
+        cachePath = "evolve-" + options["objective"] + "-" + options["width"] + "x" + options["height"] + "-"
+                    + options["generations"] + "g-" + options["seeds"] + "s.csv";
+    }
+    if (!cachePath.empty()) {
+        std::ifstream cached(cachePath);
+        if (!search.ReadCache(cached, setup)) {
+            std::cerr << cachePath << " caches evaluations for another setup than `" << setup
+                      << "`; pick another cache file or cache= to disable caching\n";
+            return 1;
+        }
+    }
+
+    std::cout << "round,best_fitness,mean_fitness,birth,survival,near_weight,far_weight,runs,cache_hits\n";
+    const int rounds = std::stoi(options["rounds"]);
+    for (int round = 0; round < rounds; round++) {
+        search.Evaluate();
+
+        const size_t best = search.Best();
+        const Genome & genome = search.Population()[best];
+        double mean = 0;
+        for (double value : search.Fitness()) {
+            mean += value / search.Fitness().size();
+        }
+        std::cout << round << "," << search.Fitness()[best] << "," << mean << "," << genome.Birth() << ","
+                  << genome.Survival() << "," << genome.NearWeight() << "," << genome.FarWeight() << ","
+                  << search.Runs() << "," << search.CacheHits() << std::endl;
+
+        if (!cachePath.empty()) {
+            std::ofstream cache(cachePath);
+            search.WriteCache(cache, setup);
+        }
+        if (round + 1 < rounds) {
+            search.Breed();
+        }
+    }
+    return 0;
+}
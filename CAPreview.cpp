@@ -0,0 +1,79 @@
+// File: CAPreview.cpp
+// Created on: October 18th, 2026
+
+// Native tool that runs a coarse preview of a grid and the full-resolution
+// run from the same start, and reports how well the preview predicted it.
+// Use it to choose a preview factor and warm-up before triaging a sweep.
+//
+// Build: g++ -std=c++17 -O3 -march=native -pthread CAPreview.cpp -o CAPreview
+// Usage: ./CAPreview [key=value ...]
+//   width, height, generations, factor, warmup, seed, birth, survival,
+//   near_weight, far_weight, interval, threads, early_stop
+
+#include "CAPreview.hpp" // Include the coarse-grid previews
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+
+int main(int argc, char * argv[]) {
+    std::map<std::string, std::string> options = {
+        {"width", "512"}, {"height", "512"}, {"generations", "1000"}, {"factor", "2"}, {"warmup", "20"},
+        {"seed", "1"}, {"birth", "0.275"}, {"survival", "0.8"}, {"near_weight", "0.5"}, {"far_weight", "0.5"},
+        {"interval", "10"}, {"threads", std::to_string(std::max(1u, std::thread::hardware_concurrency()))},
+        {"early_stop", "1"},
+    };
+    for (int k = 1; k < argc; k++) {
+        const std::string argument = argv[k];
+        const size_t equals = argument.find('=');
+        if (equals == std::string::npos || !options.count(argument.substr(0, equals))) {
+            std::cerr << "Unknown option `" << argument << "`; options are key=value with keys:";
+            for (const auto & option : options) {
+                std::cerr << " " << option.first;
+            }
+            std::cerr << "\n";
+            return 1;
+        }
+        options[argument.substr(0, equals)] = argument.substr(equals + 1);
+    }
+
+    const int width = std::stoi(options["width"]);
+    const int height = std::stoi(options["height"]);
+    const size_t generations = std::stoull(options["generations"]);
+    const int factor = std::max(1, std::stoi(options["factor"]));
+    const size_t warmup = std::stoull(options["warmup"]);
+    const size_t interval = std::stoull(options["interval"]);
+    const bool earlyStop = options["early_stop"] == "1";
+
+    ThreadPool pool(std::stoi(options["threads"]));
+    CAEngine full(width, height, pool);
+    full.birth = std::stod(options["birth"]);
+    full.survival = std::stod(options["survival"]);
+    full.nearWeight = std::stof(options["near_weight"]);
+    full.farWeight = std::stof(options["far_weight"]);
+    full.SeedGliders(size_t(width) * height / 100, std::stoull(options["seed"]));
+
+    // Both runs start after the full-resolution warm-up, so the preview is
+    // coarsened from a grid whose fine structure has already spread out
+    for (size_t g = 0; g < warmup && g < generations; g++) {
+        full.Step();
+    }
+    const size_t remaining = generations - std::min(warmup, generations);
+
+    CAEngine coarse(CAEngine::CoarseSize(width, factor), CAEngine::CoarseSize(height, factor), pool);
+    coarse.LoadCoarse(full, factor);
+
+    TerminationMonitor previewMonitor(DefaultTerminationCriteria());
+    const RunTrace preview = TraceRun(coarse, remaining, interval, earlyStop ? &previewMonitor : nullptr);
+
+    TerminationMonitor fullMonitor(DefaultTerminationCriteria());
+    const RunTrace fullTrace = TraceRun(full, remaining, interval, earlyStop ? &fullMonitor : nullptr);
+
+    std::cout << width << "x" << height << " grid, preview " << coarse.GetWidth() << "x" << coarse.GetHeight()
+              << " (radii " << coarse.nearRadius << " and " << coarse.farRadius << "), both from generation "
+              << std::min(warmup, generations) << "; curve generations count from there\n";
+    WritePreviewReport(std::cout, fullTrace, preview);
+    return 0;
+}
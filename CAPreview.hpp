@@ -0,0 +1,136 @@
+// File: CAPreview.hpp
+// Created on: October 18th, 2026
+
+// Coarse-grid previews: run a box-averaged, downsampled copy of a grid to
+// estimate how the full-resolution run will turn out, and compare the two
+// when both are available, so sweeps can triage parameter sets cheaply.
+
+#ifndef CA_PREVIEW_HPP
+#define CA_PREVIEW_HPP
+
+#include "CAEngine.hpp"    // Include the headless automaton
+#include "Termination.hpp" // Include the early-termination criteria
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ostream>
+#include <vector>
+
+/**
+ * @brief What a run did: its population curve, how it ended and how long it took.
+ */
+struct RunTrace {
+    std::vector<float> liveFraction; // Fraction of live cells, one sample every `interval` generations
+    std::vector<float> meanState;    // Average state, sampled alongside
+    size_t interval = 1;
+    size_t generations = 0;          // Generations actually run
+    TerminationReason reason = TerminationReason::None;
+    double seconds = 0;              // Wall-clock time of the run
+};
+
+/**
+ * @brief Steps an engine, recording its trace.
+ *
+ * @param engine The engine to run, from whatever state it is in.
+ * @param generations The most generations to run.
+ * @param interval Record a sample every this many generations.
+ * @param monitor If given, stops the run early when its criteria are met.
+ */
+inline RunTrace TraceRun(CAEngine & engine, size_t generations, size_t interval, TerminationMonitor * monitor) {
+    RunTrace trace;
+    trace.interval = std::max<size_t>(interval, 1);
+    const auto start = std::chrono::steady_clock::now();
+
+    GridStats stats;
+    for (size_t g = 1; g <= generations; g++) {
+        engine.Step(&stats);
+        trace.generations = g;
+        if (g % trace.interval == 0) {
+            trace.liveFraction.push_back(float(double(stats.alive) / stats.cells));
+            trace.meanState.push_back(float(stats.sum / stats.cells));
+        }
+        if (monitor) {
+            trace.reason = monitor->Check(stats, engine.GetGeneration());
+            if (trace.reason != TerminationReason::None) {
+                break;
+            }
+        }
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    trace.seconds = elapsed.count();
+    return trace;
+}
+
+/**
+ * @brief How closely a coarse preview tracked the full-resolution run.
+ */
+struct PreviewComparison {
+    bool sameOutcome = false;   // Both stopped for the same reason, or both ran to the end
+    float finalLiveError = 0;   // |preview - full| of the last live fraction each recorded
+    float finalMeanError = 0;   // |preview - full| of the last mean state each recorded
+    float meanLiveError = 0;    // Average |preview - full| live fraction over the samples both have
+    float maxLiveError = 0;     // Largest |preview - full| live fraction over those samples
+    double speedup = 0;         // Full run time over preview time
+};
+
+/**
+ * @brief Compares a preview's trace with the full run's; both must use the same sampling interval.
+ */
+inline PreviewComparison ComparePreview(const RunTrace & full, const RunTrace & preview) {
+    PreviewComparison result;
+    result.sameOutcome = full.reason == preview.reason;
+    if (!full.liveFraction.empty() && !preview.liveFraction.empty()) {
+        result.finalLiveError = std::fabs(full.liveFraction.back() - preview.liveFraction.back());
+        result.finalMeanError = std::fabs(full.meanState.back() - preview.meanState.back());
+    }
+    const size_t shared = std::min(full.liveFraction.size(), preview.liveFraction.size());
+    for (size_t k = 0; k < shared; k++) {
+        const float error = std::fabs(full.liveFraction[k] - preview.liveFraction[k]);
+        result.meanLiveError += error / shared;
+        result.maxLiveError = std::max(result.maxLiveError, error);
+    }
+    result.speedup = preview.seconds > 0 ? full.seconds / preview.seconds : 0;
+    return result;
+}
+
+/**
+ * @brief Writes a readable comparison report: a summary, then both population curves as CSV.
+ */
+inline void WritePreviewReport(std::ostream & out, const RunTrace & full, const RunTrace & preview) {
+    const PreviewComparison comparison = ComparePreview(full, preview);
+    out << "full:    " << full.generations << " generations, stopped by " << DescribeTermination(full.reason)
+        << ", " << full.seconds << " s\n";
+    out << "preview: " << preview.generations << " generations, stopped by " << DescribeTermination(preview.reason)
+        << ", " << preview.seconds << " s (" << comparison.speedup << "x faster)\n";
+    out << "same outcome: " << (comparison.sameOutcome ? "yes" : "no") << "\n";
+    out << "final live fraction error: " << comparison.finalLiveError
+        << ", final mean state error: " << comparison.finalMeanError << "\n";
+    out << "live fraction error over time: mean " << comparison.meanLiveError
+        << ", max " << comparison.maxLiveError << "\n\n";
+
+    out << "generation,full_live,preview_live,full_mean,preview_mean\n";
+    const size_t samples = std::max(full.liveFraction.size(), preview.liveFraction.size());
+    for (size_t k = 0; k < samples; k++) {
+        out << (k + 1) * full.interval << ",";
+        if (k < full.liveFraction.size()) {
+            out << full.liveFraction[k];
+        }
+        out << ",";
+        if (k < preview.liveFraction.size()) {
+            out << preview.liveFraction[k];
+        }
+        out << ",";
+        if (k < full.meanState.size()) {
+            out << full.meanState[k];
+        }
+        out << ",";
+        if (k < preview.meanState.size()) {
+            out << preview.meanState[k];
+        }
+        out << "\n";
+    }
+}
+
+#endif
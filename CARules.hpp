@@ -0,0 +1,60 @@
+// File: CARules.hpp
+// Created on: October 18th, 2026
+
+// The update rule and neighborhood average shared by every stepper: the
+// page's kernels, the headless CAEngine, the sparse and deduplicated tile
+// steppers and the 3D volume. With one copy they agree exactly, down to the
+// order in which neighbors are added up.
+
+#ifndef CA_RULES_HPP
+#define CA_RULES_HPP
+
+/**
+ * @brief Applies rules to determine the next state of a cell based on its current state and neighbors' average.
+ *
+ * Live cells (state 1) stay alive while the average is at or below the
+ * survival threshold; any other cell comes alive once it reaches the birth
+ * threshold. A cell alive in the next generation takes the state halfway
+ * between the average and 1.
+ *
+ * @param currentState The current state of the cell.
+ * @param allNeighborsAvg The weighted average state of its neighbors.
+ * @param birth The neighbor average at or above which a dead cell comes alive.
+ * @param survival The neighbor average above which a live cell dies.
+ * @return The updated state of the cell.
+ */
+inline float ApplyRules(float currentState, float allNeighborsAvg, double birth, double survival) {
+    if (currentState == 1) {
+        return allNeighborsAvg <= survival ? (1 + allNeighborsAvg) / 2 : 0;
+    }
+    return allNeighborsAvg >= birth ? (1 + allNeighborsAvg) / 2 : 0;
+}
+
+/**
+ * @brief The average state of the cells within a square around (x, y), excluding the cell itself.
+ *
+ * Neighbors are added column by column, top to bottom; every stepper goes
+ * through here so their float sums are identical.
+ *
+ * @param x The x-coordinate of the cell.
+ * @param y The y-coordinate of the cell.
+ * @param size The radius of the square.
+ * @param cell Called as cell(i, j) for each neighbor's state; does any wrapping.
+ * @return The average state of the (2 * size + 1)^2 - 1 neighbors.
+ */
+template <typename CELL>
+float NeighborhoodAvg(int x, int y, int size, CELL && cell) {
+    float sum = 0;
+    const int count = (2 * size + 1) * (2 * size + 1) - 1;
+    for (int i = x - size; i <= x + size; i++) {
+        for (int j = y - size; j <= y + size; j++) {
+            if (i == x && j == y) {
+                continue;
+            }
+            sum += cell(i, j);
+        }
+    }
+    return sum / count;
+}
+
+#endif
@@ -0,0 +1,720 @@
+// File: CASweep.cpp
+// Created on: October 18th, 2026
+
+// Native, resumable parameter sweeps. A manifest lists values for each rule
+// parameter and a set of seeds; every combination is one job. A pool of
+// worker processes claims jobs, checkpoints long runs, and writes each
+// result atomically, so a sweep killed at any point (even by a power cut)
+// picks up where it left off when the same command is run again.
+//
+// Build: g++ -std=c++17 -O3 -march=native -pthread CASweep.cpp -o CASweep
+// Usage: ./CASweep <manifest> <output directory> [worker processes]
+
+#include "CAEngine.hpp"    // Include the headless automaton
+#include "CAPreview.hpp"   // Include the coarse-grid previews
+#include "Ensemble.hpp"    // Include the streaming ensemble statistics
+#include "Termination.hpp" // Include the early-termination criteria
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * @brief The contents of a sweep manifest.
+ *
+ * The manifest is a text file of `key = values` lines; `#` starts a comment.
+ * Lists are separated by spaces, and seeds also accept ranges like `1-100`.
+ *
+ *     width = 256
+ *     height = 256
+ *     generations = 5000
+ *     checkpoint_interval = 500
+ *     birth = 0.2 0.25 0.3
+ *     survival = 0.7 0.8
+ *     near_weight = 0.5
+ *     far_weight = 0.5
+ *     seeds = 1-20
+ *     early_stop = 1
+ *     preview_factor = 2
+ *     preview_warmup = 20
+ *     triage = 1
+ *     aggregate = 1
+ *     sample_interval = 10
+ */
+struct Manifest {
+    int width = 100;
+    int height = 100;
+    size_t generations = 1000;
+    size_t checkpointInterval = 500; // Generations between checkpoints; 0 disables them
+    double gliderDensity = 0.01;     // Gliders seeded per cell, as on the page
+    bool earlyStop = false;          // Stop runs on the page's default termination criteria
+    int previewFactor = 0;           // Run a preview this many times coarser before each job (0 disables)
+    size_t previewWarmup = 20;       // Full-resolution generations run before the grid is coarsened
+    bool triage = false;             // Skip the full run when the preview dies out or fills up
+    bool aggregate = false;          // Fold every full run into ensemble statistics
+    size_t sampleInterval = 10;      // Generations between points of the ensemble curves
+    std::vector<double> birth{0.275};
+    std::vector<double> survival{0.8};
+    std::vector<double> nearWeight{0.5};
+    std::vector<double> farWeight{0.5};
+    std::vector<uint64_t> seeds{1};
+};
+
+/**
+ * @brief One run of the sweep: a parameter combination and a seed.
+ */
+struct Job {
+    size_t id;
+    double birth;
+    double survival;
+    double nearWeight;
+    double farWeight;
+    uint64_t seed;
+};
+
+/**
+ * @brief Reads a manifest, exiting with a message if it is malformed.
+ */
+Manifest ReadManifest(const std::string & path) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Can't read manifest " << path << "\n";
+        std::exit(1);
+    }
+
+    Manifest manifest;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+        const size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            if (line.find_first_not_of(" \t\r") != std::string::npos) {
+                std::cerr << path << ":" << lineNumber << ": expected `key = values`\n";
+                std::exit(1);
+            }
+            continue;
+        }
+
+        std::istringstream keyStream(line.substr(0, equals));
+        std::string key;
+        keyStream >> key;
+        std::istringstream values(line.substr(equals + 1));
+
+        auto readList = [&](std::vector<double> & out) {
+            out.clear();
+            double value;
+            while (values >> value) {
+                out.push_back(value);
+            }
+        };
+
+        if (key == "width") {
+            values >> manifest.width;
+        } else if (key == "height") {
+            values >> manifest.height;
+        } else if (key == "generations") {
+            values >> manifest.generations;
+        } else if (key == "checkpoint_interval") {
+            values >> manifest.checkpointInterval;
+        } else if (key == "glider_density") {
+            values >> manifest.gliderDensity;
+        } else if (key == "early_stop") {
+            values >> manifest.earlyStop;
+        } else if (key == "preview_factor") {
+            values >> manifest.previewFactor;
+        } else if (key == "preview_warmup") {
+            values >> manifest.previewWarmup;
+        } else if (key == "triage") {
+            values >> manifest.triage;
+        } else if (key == "aggregate") {
+            values >> manifest.aggregate;
+        } else if (key == "sample_interval") {
+            values >> manifest.sampleInterval;
+        } else if (key == "birth") {
+            readList(manifest.birth);
+        } else if (key == "survival") {
+            readList(manifest.survival);
+        } else if (key == "near_weight") {
+            readList(manifest.nearWeight);
+        } else if (key == "far_weight") {
+            readList(manifest.farWeight);
+        } else if (key == "seeds") {
+            manifest.seeds.clear();
+            std::string item;
+            while (values >> item) {
+                const size_t dash = item.find('-');
+                const uint64_t first = std::stoull(item.substr(0, dash));
+                const uint64_t last = dash == std::string::npos ? first : std::stoull(item.substr(dash + 1));
+                for (uint64_t seed = first; seed <= last; seed++) {
+                    manifest.seeds.push_back(seed);
+                }
+            }
+        } else {
+            std::cerr << path << ":" << lineNumber << ": unknown key `" << key << "`\n";
+            std::exit(1);
+        }
+    }
+
+    if (manifest.width <= 0 || manifest.height <= 0 || manifest.sampleInterval == 0 || manifest.birth.empty() || manifest.survival.empty() ||
+        manifest.nearWeight.empty() || manifest.farWeight.empty() || manifest.seeds.empty()) {
+        std::cerr << path << ": the grid must be non-empty and every list needs at least one value\n";
+        std::exit(1);
+    }
+    return manifest;
+}
+
+/**
+ * @brief Expands a manifest into its jobs, seeds varying fastest.
+ *
+ * The order only depends on the manifest, so job ids are stable across restarts.
+ */
+std::vector<Job> ExpandJobs(const Manifest & manifest) {
+    std::vector<Job> jobs;
+    for (double birth : manifest.birth) {
+        for (double survival : manifest.survival) {
+            for (double nearWeight : manifest.nearWeight) {
+                for (double farWeight : manifest.farWeight) {
+                    for (uint64_t seed : manifest.seeds) {
+                        jobs.push_back({jobs.size(), birth, survival, nearWeight, farWeight, seed});
+                    }
+                }
+            }
+        }
+    }
+    return jobs;
+}
+
+/**
+ * @brief The fraction of cells in a grid that are alive.
+ */
+double LiveFraction(const std::vector<float> & cells) {
+    return double(cells.size() - std::count(cells.begin(), cells.end(), 0.0f)) / cells.size();
+}
+
+bool FileExists(const std::string & path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0;
+}
+
+void MakeDirectory(const std::string & path) {
+    if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::perror(path.c_str());
+        std::exit(1);
+    }
+}
+
+/**
+ * @brief Flushes a directory's entries to disk, so a rename in it survives a crash.
+ */
+void SyncDirectory(const std::string & path) {
+    const int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+/**
+ * @brief Replaces a file with new contents so that readers see the old file or the new one, never a mix.
+ *
+ * The data goes to a temporary file in the same directory, which is synced
+ * to disk and then renamed over the target.
+ */
+bool WriteAtomically(const std::string & directory, const std::string & name, const std::string & contents) {
+    const std::string target = directory + "/" + name;
+    const std::string temporary = target + ".tmp." + std::to_string(getpid());
+
+    const int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    size_t written = 0;
+    while (written < contents.size()) {
+        const ssize_t n = write(fd, contents.data() + written, contents.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            close(fd);
+            unlink(temporary.c_str());
+            return false;
+        }
+        written += size_t(n);
+    }
+    if (fsync(fd) != 0 || close(fd) != 0 || rename(temporary.c_str(), target.c_str()) != 0) {
+        unlink(temporary.c_str());
+        return false;
+    }
+    SyncDirectory(directory);
+    return true;
+}
+
+std::string ReadFile(const std::string & path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+
+/**
+ * @brief What a finished job produced.
+ */
+struct JobOutcome {
+    std::string line;        // The job's row of the results table
+    bool fullRun = false;    // False when the job was triaged
+    std::vector<float> live; // Live fraction every sampleInterval generations (when aggregating)
+    std::vector<float> mean; // Mean state at the same generations
+    size_t generations = 0;
+    double finalLive = 0;
+    double finalMean = 0;
+    TerminationReason reason = TerminationReason::None;
+};
+
+/**
+ * @brief Appends a run's sampled curve to a checkpoint.
+ */
+void SaveCurve(std::ostream & out, const JobOutcome & outcome) {
+    const uint64_t samples = outcome.live.size();
+    out.write(reinterpret_cast<const char *>(&samples), sizeof(samples));
+    out.write(reinterpret_cast<const char *>(outcome.live.data()), std::streamsize(samples * sizeof(float)));
+    out.write(reinterpret_cast<const char *>(outcome.mean.data()), std::streamsize(samples * sizeof(float)));
+}
+
+bool LoadCurve(std::istream & in, JobOutcome & outcome) {
+    uint64_t samples;
+    if (!in.read(reinterpret_cast<char *>(&samples), sizeof(samples)) || samples > (uint64_t(1) << 32)) {
+        return false;
+    }
+    outcome.live.resize(samples);
+    outcome.mean.resize(samples);
+    return bool(in.read(reinterpret_cast<char *>(outcome.live.data()), std::streamsize(samples * sizeof(float)))) &&
+           bool(in.read(reinterpret_cast<char *>(outcome.mean.data()), std::streamsize(samples * sizeof(float))));
+}
+
+/**
+ * @brief Runs one job to completion, resuming from its checkpoint if there is one.
+ *
+ * With a preview factor, the grid is run at full resolution for the
+ * warm-up, then a coarse copy of it runs the remaining generations (always
+ * with early stopping). Coarsening the freshly seeded gliders would blur
+ * them away, so the warm-up lets their structure spread first. With triage,
+ * a preview that dies out or fills up is taken as the job's outcome and
+ * the full run is skipped.
+ *
+ * When aggregating, the run's curve is sampled as it goes and saved with
+ * each checkpoint, so a resumed run still contributes its whole curve.
+ */
+JobOutcome RunJob(const Manifest & manifest, const Job & job, const std::string & outDir) {
+    ThreadPool pool(1); // Parallelism comes from running one job per process
+    CAEngine engine(manifest.width, manifest.height, pool);
+    engine.birth = job.birth;
+    engine.survival = job.survival;
+    engine.nearWeight = float(job.nearWeight);
+    engine.farWeight = float(job.farWeight);
+    const size_t gliders = size_t(manifest.gliderDensity * manifest.width * manifest.height);
+
+    RunTrace preview;
+    std::ostringstream previewColumns;
+    previewColumns.precision(9);
+    if (manifest.previewFactor > 1) {
+        engine.SeedGliders(gliders, job.seed);
+        const size_t warmup = std::min(manifest.previewWarmup, manifest.generations);
+        for (size_t g = 0; g < warmup; g++) {
+            engine.Step();
+        }
+        CAEngine coarse(CAEngine::CoarseSize(manifest.width, manifest.previewFactor),
+                        CAEngine::CoarseSize(manifest.height, manifest.previewFactor), pool);
+        coarse.LoadCoarse(engine, manifest.previewFactor);
+        TerminationMonitor previewMonitor(DefaultTerminationCriteria());
+        preview = TraceRun(coarse, manifest.generations - warmup, manifest.generations, &previewMonitor);
+        previewColumns << DescribeTermination(preview.reason) << "," << LiveFraction(coarse.GetCells());
+    } else {
+        previewColumns << ",";
+    }
+
+    if (manifest.triage && (preview.reason == TerminationReason::Extinction || preview.reason == TerminationReason::Saturation)) {
+        std::ostringstream line;
+        line.precision(9);
+        line << job.id << "," << job.birth << "," << job.survival << "," << job.nearWeight << "," << job.farWeight
+             << "," << job.seed << ",0,triaged,,," << previewColumns.str() << "\n";
+        JobOutcome outcome;
+        outcome.line = line.str();
+        return outcome;
+    }
+
+    TerminationMonitor monitor;
+    if (manifest.earlyStop) {
+        monitor.SetCriteria(DefaultTerminationCriteria());
+    }
+
+    const std::string checkpointDir = outDir + "/checkpoints";
+    const std::string checkpointName = std::to_string(job.id) + ".ckpt";
+    std::ifstream checkpoint(checkpointDir + "/" + checkpointName, std::ios::binary);
+    JobOutcome outcome;
+    outcome.fullRun = true;
+    if (checkpoint && engine.Load(checkpoint) && monitor.LoadState(checkpoint) && LoadCurve(checkpoint, outcome)) {
+        std::cerr << "Job " << job.id << ": resuming at generation " << engine.GetGeneration() << "\n";
+    } else {
+        engine.SeedGliders(gliders, job.seed);
+        outcome.live.clear();
+        outcome.mean.clear();
+    }
+    checkpoint.close();
+
+    GridStats stats;
+    TerminationReason reason = TerminationReason::None;
+    while (engine.GetGeneration() < manifest.generations && reason == TerminationReason::None) {
+        engine.Step(&stats);
+        if (manifest.earlyStop) {
+            reason = monitor.Check(stats, engine.GetGeneration());
+        }
+        if (manifest.aggregate && engine.GetGeneration() % manifest.sampleInterval == 0) {
+            outcome.live.push_back(float(double(stats.alive) / stats.cells));
+            outcome.mean.push_back(float(stats.sum / stats.cells));
+        }
+
+        if (manifest.checkpointInterval > 0 && engine.GetGeneration() % manifest.checkpointInterval == 0 &&
+            engine.GetGeneration() < manifest.generations && reason == TerminationReason::None) {
+            std::ostringstream state;
+            engine.Save(state);
+            monitor.SaveState(state);
+            SaveCurve(state, outcome);
+            if (!WriteAtomically(checkpointDir, checkpointName, state.str())) {
+                std::cerr << "Job " << job.id << ": can't write checkpoint\n";
+            }
+        }
+    }
+
+    // Statistics of the final grid (a resumed run that was already done has none yet)
+    if (engine.GetGeneration() == 0 || stats.cells == 0) {
+        stats = GridStats();
+        for (size_t index = 0; index < engine.GetCells().size(); index++) {
+            stats.AddState(index, engine.GetCells()[index]);
+        }
+    }
+
+    std::ostringstream line;
+    line.precision(9);
+    line << job.id << "," << job.birth << "," << job.survival << "," << job.nearWeight << "," << job.farWeight
+         << "," << job.seed << "," << engine.GetGeneration() << "," << DescribeTermination(reason) << ","
+         << double(stats.alive) / stats.cells << "," << stats.sum / stats.cells << "," << previewColumns.str() << "\n";
+    outcome.line = line.str();
+    outcome.generations = engine.GetGeneration();
+    outcome.finalLive = double(stats.alive) / stats.cells;
+    outcome.finalMean = stats.sum / stats.cells;
+    outcome.reason = reason;
+    return outcome;
+}
+
+/**
+ * @brief A worker slot's share of the ensemble statistics, as kept on disk.
+ *
+ * Each worker slot folds its runs into its own aggregate, in
+ * aggregates/<slot>.agg. Folding a run and recording its result must happen
+ * exactly once together, so the aggregate file is the commit point: it is
+ * written with the result line of the run just folded in as "pending", and
+ * the result file is written after it. If the worker dies in between, the
+ * pending result is written out before the slot runs anything else, and a
+ * worker that claims the job again writes it out instead of running it, so
+ * the run is never folded into two slots.
+ */
+struct SlotAggregate {
+    EnsembleAggregator aggregate;
+    uint64_t pendingJob = UINT64_MAX; // Job whose result may not be written yet
+    std::string pendingLine;
+
+    explicit SlotAggregate(const Manifest & manifest) : aggregate(manifest.generations, manifest.sampleInterval) { }
+
+    static std::string Name(int slot) { return std::to_string(slot) + ".agg"; }
+
+    bool Load(const std::string & path) {
+        std::ifstream in(path, std::ios::binary);
+        uint64_t job;
+        std::string line;
+        if (!ReadPending(in, job, line) || !aggregate.Load(in)) {
+            return false;
+        }
+        pendingJob = job;
+        pendingLine = line;
+        return true;
+    }
+
+    /**
+     * @brief Reads just the pending job and its result line from the start of an aggregate file.
+     */
+    static bool ReadPending(std::istream & in, uint64_t & job, std::string & line) {
+        uint64_t header[2];
+        if (!in.read(reinterpret_cast<char *>(header), sizeof(header))) {
+            return false;
+        }
+        line.assign(header[1], '\0');
+        if (!in.read(&line[0], std::streamsize(line.size()))) {
+            return false;
+        }
+        job = header[0];
+        return true;
+    }
+
+    bool Save(const std::string & aggregateDir, int slot) const {
+        std::ostringstream out;
+        const uint64_t header[2] = { pendingJob, uint64_t(pendingLine.size()) };
+        out.write(reinterpret_cast<const char *>(header), sizeof(header));
+        out << pendingLine;
+        aggregate.Save(out);
+        return WriteAtomically(aggregateDir, Name(slot), out.str());
+    }
+};
+
+/**
+ * @brief Writes the result of a worker slot's last folded run if it is missing.
+ */
+void ResolvePending(const Manifest & manifest, const std::string & outDir, int slot) {
+    SlotAggregate saved(manifest);
+    if (!saved.Load(outDir + "/aggregates/" + SlotAggregate::Name(slot)) || saved.pendingJob == UINT64_MAX) {
+        return;
+    }
+    const std::string resultName = std::to_string(saved.pendingJob) + ".csv";
+    if (!FileExists(outDir + "/results/" + resultName)) {
+        WriteAtomically(outDir + "/results", resultName, saved.pendingLine);
+        unlink((outDir + "/checkpoints/" + std::to_string(saved.pendingJob) + ".ckpt").c_str());
+    }
+}
+
+/**
+ * @brief The highest worker slot with an aggregate file, or -1 if there are none.
+ */
+int HighestSlot(const std::string & outDir) {
+    int highest = -1;
+    DIR * directory = opendir((outDir + "/aggregates").c_str());
+    if (!directory) {
+        return highest;
+    }
+    while (const dirent * entry = readdir(directory)) {
+        const std::string name = entry->d_name;
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".agg") == 0 &&
+            name.find_first_not_of("0123456789") == name.size() - 4) {
+            highest = std::max(highest, std::atoi(name.c_str()));
+        }
+    }
+    closedir(directory);
+    return highest;
+}
+
+/**
+ * @brief Writes a job's result from whichever worker slot holds it as pending.
+ *
+ * A worker that died after folding the job in, but before writing its
+ * result, leaves it pending in its slot; running the job again would fold
+ * it into a second slot as well.
+ *
+ * @return True if a slot held the job and its result was written.
+ */
+bool ResolvePendingJob(const std::string & outDir, uint64_t jobId) {
+    for (int slot = 0; slot <= HighestSlot(outDir); slot++) {
+        std::ifstream in(outDir + "/aggregates/" + SlotAggregate::Name(slot), std::ios::binary);
+        uint64_t job;
+        std::string line;
+        if (in && SlotAggregate::ReadPending(in, job, line) && job == jobId) {
+            if (!WriteAtomically(outDir + "/results", std::to_string(jobId) + ".csv", line)) {
+                return false;
+            }
+            unlink((outDir + "/checkpoints/" + std::to_string(jobId) + ".ckpt").c_str());
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief The loop of one worker process: claim an unfinished job, run it, repeat.
+ *
+ * A job is claimed by holding an flock() on its lock file, which the kernel
+ * releases if the worker dies, so a crashed worker's job is simply claimed
+ * again. Workers start at different jobs to avoid contending for the same locks.
+ */
+void WorkerLoop(const Manifest & manifest, const std::vector<Job> & jobs, const std::string & outDir, int worker, int workers) {
+    const std::string aggregateDir = outDir + "/aggregates";
+    SlotAggregate slot(manifest);
+    if (manifest.aggregate) {
+        ResolvePending(manifest, outDir, worker);
+        slot.Load(aggregateDir + "/" + SlotAggregate::Name(worker));
+    }
+
+    const size_t first = jobs.size() * size_t(worker) / size_t(workers);
+    for (size_t k = 0; k < jobs.size(); k++) {
+        const Job & job = jobs[(first + k) % jobs.size()];
+        const std::string resultName = std::to_string(job.id) + ".csv";
+        if (FileExists(outDir + "/results/" + resultName)) {
+            continue;
+        }
+
+        const std::string lockPath = outDir + "/locks/" + std::to_string(job.id) + ".lock";
+        const int lock = open(lockPath.c_str(), O_RDWR | O_CREAT, 0644);
+        if (lock < 0 || flock(lock, LOCK_EX | LOCK_NB) != 0) {
+            if (lock >= 0) {
+                close(lock);
+            }
+            continue; // Another worker has it
+        }
+
+        // It may have finished between the first check and taking the lock, or
+        // been folded in by a worker that died before writing its result
+        if (!FileExists(outDir + "/results/" + resultName) &&
+            !(manifest.aggregate && ResolvePendingJob(outDir, job.id))) {
+            const JobOutcome outcome = RunJob(manifest, job, outDir);
+
+            // Fold the run in and commit that, unless its result appeared meanwhile
+            if (manifest.aggregate && outcome.fullRun && !FileExists(outDir + "/results/" + resultName)) {
+                SlotAggregate next = slot;
+                next.aggregate.AddRun(outcome.live, outcome.mean, outcome.generations, outcome.finalLive,
+                                      outcome.finalMean, outcome.reason);
+                next.pendingJob = job.id;
+                next.pendingLine = outcome.line;
+                if (!next.Save(aggregateDir, worker)) {
+                    std::cerr << "Job " << job.id << ": can't write ensemble statistics\n";
+                    close(lock);
+                    continue;
+                }
+                slot = std::move(next);
+            }
+            if (WriteAtomically(outDir + "/results", resultName, outcome.line)) {
+                unlink((outDir + "/checkpoints/" + std::to_string(job.id) + ".ckpt").c_str());
+            } else {
+                std::cerr << "Job " << job.id << ": can't write result\n";
+            }
+        }
+        close(lock);
+    }
+}
+
+int main(int argc, char * argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <manifest> <output directory> [worker processes]\n";
+        return 1;
+    }
+    const std::string manifestPath = argv[1];
+    const std::string outDir = argv[2];
+    const int workers = argc > 3 ? std::max(1, std::atoi(argv[3])) : std::max(1, int(sysconf(_SC_NPROCESSORS_ONLN)));
+
+    const Manifest manifest = ReadManifest(manifestPath);
+    const std::vector<Job> jobs = ExpandJobs(manifest);
+
+    // The output directory keeps a copy of the manifest; resuming with a
+    // different one would mix results from two sweeps under the same job ids
+    MakeDirectory(outDir);
+    const std::string manifestText = ReadFile(manifestPath);
+    const std::string savedManifest = outDir + "/manifest";
+    if (FileExists(savedManifest)) {
+        if (ReadFile(savedManifest) != manifestText) {
+            std::cerr << outDir << " holds a different sweep; use a new output directory\n";
+            return 1;
+        }
+    } else if (!WriteAtomically(outDir, "manifest", manifestText)) {
+        std::cerr << "Can't write " << savedManifest << "\n";
+        return 1;
+    }
+    MakeDirectory(outDir + "/results");
+    MakeDirectory(outDir + "/checkpoints");
+    MakeDirectory(outDir + "/locks");
+    MakeDirectory(outDir + "/aggregates");
+    if (manifest.aggregate) {
+        // Finish any result left pending when the last session died
+        for (int slot = 0; slot < std::max(workers, HighestSlot(outDir) + 1); slot++) {
+            ResolvePending(manifest, outDir, slot);
+        }
+    }
+
+    std::cerr << jobs.size() << " jobs, " << workers << " workers\n";
+
+    // Start the workers, and replace any that die before the sweep is done
+    std::map<pid_t, int> running; // Worker process -> worker number
+    auto spawn = [&](int worker) {
+        const pid_t pid = fork();
+        if (pid == 0) {
+            WorkerLoop(manifest, jobs, outDir, worker, workers);
+            std::_Exit(0);
+        }
+        if (pid < 0) {
+            std::perror("fork");
+            return;
+        }
+        running[pid] = worker;
+    };
+    for (int worker = 0; worker < workers; worker++) {
+        spawn(worker);
+    }
+    int restartsLeft = 3 * workers;
+    while (!running.empty()) {
+        int status;
+        const pid_t pid = wait(&status);
+        if (pid < 0) {
+            break;
+        }
+        const int worker = running[pid];
+        running.erase(pid);
+        if (!(WIFEXITED(status) && WEXITSTATUS(status) == 0)) {
+            if (manifest.aggregate) {
+                ResolvePending(manifest, outDir, worker);
+            }
+            std::cerr << "Worker " << worker << " died; " << (restartsLeft > 0 ? "restarting it" : "giving up on it") << "\n";
+            if (restartsLeft-- > 0) {
+                spawn(worker);
+            }
+        }
+    }
+
+    // Gather every result into one table, in job order
+    std::string table = "job,birth,survival,near_weight,far_weight,seed,generations,stop_reason,live_fraction,mean_state,"
+                        "preview_stop_reason,preview_live_fraction\n";
+    size_t done = 0;
+    for (const Job & job : jobs) {
+        const std::string path = outDir + "/results/" + std::to_string(job.id) + ".csv";
+        if (FileExists(path)) {
+            table += ReadFile(path);
+            done++;
+        }
+    }
+    if (!WriteAtomically(outDir, "results.csv", table)) {
+        std::cerr << "Can't write " << outDir << "/results.csv\n";
+        return 1;
+    }
+    std::cerr << done << " of " << jobs.size() << " jobs done; results in " << outDir << "/results.csv\n";
+
+    // Merge every worker slot's ensemble statistics, including slots of earlier sessions
+    if (manifest.aggregate) {
+        EnsembleAggregator ensemble(manifest.generations, manifest.sampleInterval);
+        for (int slot = 0; slot <= HighestSlot(outDir); slot++) {
+            SlotAggregate saved(manifest);
+            if (saved.Load(outDir + "/aggregates/" + SlotAggregate::Name(slot))) {
+                ensemble.Merge(saved.aggregate);
+            }
+        }
+        std::ostringstream curves;
+        std::ostringstream summary;
+        ensemble.WriteCurves(curves);
+        ensemble.WriteSummary(summary);
+        if (!WriteAtomically(outDir, "ensemble.csv", curves.str()) || !WriteAtomically(outDir, "ensemble.txt", summary.str())) {
+            std::cerr << "Can't write the ensemble statistics\n";
+            return 1;
+        }
+        std::cerr << "Ensemble statistics over " << ensemble.Runs() << " runs in " << outDir << "/ensemble.csv and ensemble.txt\n";
+    }
+    return done == jobs.size() ? 0 : 1;
+}
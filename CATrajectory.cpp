@@ -0,0 +1,168 @@
+// File: CATrajectory.cpp
+// Created on: October 18th, 2026
+
+// Native tool that records headless runs into trajectory files (see
+// Trajectory.hpp) and reads rectangles of them back over a range of
+// generations, fetching only the chunks the query touches.
+//
+// Build: g++ -std=c++17 -O3 -march=native -pthread CATrajectory.cpp -o CATrajectory
+// Usage: ./CATrajectory record [key=value ...]
+//          out, width, height, generations, interval, seed, birth, survival,
+//          near_weight, far_weight, tile, block, threads, probe, probe_out
+//        ./CATrajectory query [key=value ...]
+//          file, x, y, width, height, from, to, mmap, sum
+
+#include "CAEngine.hpp"   // Include the headless automaton
+#include "Trajectory.hpp" // Include the chunked trajectory format
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fills `options` from key=value arguments, refusing unknown keys.
+ */
+bool ParseOptions(int argc, char * argv[], int first, std::map<std::string, std::string> & options) {
+    for (int k = first; k < argc; k++) {
+        const std::string argument = argv[k];
+        const size_t equals = argument.find('=');
+        if (equals == std::string::npos || !options.count(argument.substr(0, equals))) {
+            std::cerr << "Unknown option `" << argument << "`; options are key=value with keys:";
+            for (const auto & option : options) {
+                std::cerr << " " << option.first;
+            }
+            std::cerr << "\n";
+            return false;
+        }
+        options[argument.substr(0, equals)] = argument.substr(equals + 1);
+    }
+    return true;
+}
+
+int Record(std::map<std::string, std::string> & options) {
+    const int width = std::stoi(options["width"]);
+    const int height = std::stoi(options["height"]);
+    const size_t generations = std::stoull(options["generations"]);
+    const size_t interval = std::max<size_t>(1, std::stoull(options["interval"]));
+
+    ThreadPool pool(std::stoi(options["threads"]));
+    CAEngine engine(width, height, pool);
+    engine.birth = std::stod(options["birth"]);
+    engine.survival = std::stod(options["survival"]);
+    engine.nearWeight = std::stof(options["near_weight"]);
+    engine.farWeight = std::stof(options["far_weight"]);
+    engine.SeedGliders(size_t(width) * height / 100, std::stoull(options["seed"]));
+
+    // probe=x,y,width,height records the rectangle's sum every generation, including
+    // those between frames, sampled by the stepper as it writes each column
+    std::ofstream probeOut;
+    if (!options["probe"].empty()) {
+        int rect[4];
+        if (std::sscanf(options["probe"].c_str(), "%d,%d,%d,%d", &rect[0], &rect[1], &rect[2], &rect[3]) != 4) {
+            std::cerr << "probe must be x,y,width,height\n";
+            return 1;
+        }
+        engine.Probes().AddRect("probe", rect[0], rect[1], rect[2], rect[3], ProbeMode::Sum, 1);
+        probeOut.open(options["probe_out"]);
+        if (!probeOut) {
+            std::cerr << "Can't create " << options["probe_out"] << "\n";
+            return 1;
+        }
+        probeOut.precision(9);
+        probeOut << "generation,sum\n";
+    }
+
+    const int tile = std::stoi(options["tile"]);
+    TrajectoryWriter writer(options["out"], width, height, tile, tile, std::stoi(options["block"]));
+    if (!writer.IsOpen()) {
+        std::cerr << "Can't create " << options["out"] << "\n";
+        return 1;
+    }
+    // Frames are the starting grid and every interval-th generation after it
+    writer.Append(engine.GetCells().data(), 0);
+    while (engine.GetGeneration() < generations) {
+        engine.Step();
+        if (probeOut.is_open()) {
+            const ProbeRing & ring = engine.Probes().Ring(0);
+            probeOut << ring.Generation(ring.Size() - 1) << "," << ring.Frame(ring.Size() - 1)[0] << "\n";
+        }
+        if (engine.GetGeneration() % interval == 0 && !writer.Append(engine.GetCells().data(), engine.GetGeneration())) {
+            break;
+        }
+    }
+    if (!writer.Close()) {
+        std::cerr << "Writing " << options["out"] << " failed\n";
+        return 1;
+    }
+    return 0;
+}
+
+int Query(std::map<std::string, std::string> & options) {
+    TrajectoryReader reader(options["file"], options["mmap"] == "1");
+    if (!reader.IsOpen()) {
+        std::cerr << "Can't read a trajectory from " << options["file"] << "\n";
+        return 1;
+    }
+    const int x = std::stoi(options["x"]);
+    const int y = std::stoi(options["y"]);
+    const int width = std::stoi(options["width"]);
+    const int height = std::stoi(options["height"]);
+    const size_t first = reader.FrameAtOrAfter(std::stoull(options["from"]));
+    const size_t end = options["to"].empty() ? reader.Frames() : reader.FrameAtOrAfter(std::stoull(options["to"]) + 1);
+    const size_t count = end > first ? end - first : 0;
+
+    std::vector<float> values(size_t(width) * height * count);
+    if (!reader.Read(x, y, width, height, first, count, values.data())) {
+        std::cerr << "The rectangle or generations are outside the " << reader.GetWidth() << "x"
+                  << reader.GetHeight() << " trajectory of " << reader.Frames() << " frames\n";
+        return 1;
+    }
+
+    // One row per generation with the rectangle's sum, or one row per cell
+    const bool sum = options["sum"] == "1";
+    std::cout << (sum ? "generation,sum\n" : "generation,x,y,value\n");
+    for (size_t f = 0; f < count; f++) {
+        const float * frame = values.data() + f * size_t(width) * height;
+        double total = 0;
+        for (int i = 0; i < width; i++) {
+            for (int j = 0; j < height; j++) {
+                const float value = frame[size_t(i) * height + j];
+                if (sum) {
+                    total += value;
+                } else {
+                    std::cout << reader.Generation(first + f) << "," << x + i << "," << y + j << "," << value << "\n";
+                }
+            }
+        }
+        if (sum) {
+            std::cout << reader.Generation(first + f) << "," << total << "\n";
+        }
+    }
+    std::cerr << "Read " << reader.BytesRead() << " bytes of chunk data from a " << reader.FileSize() << "-byte file\n";
+    return 0;
+}
+
+int main(int argc, char * argv[]) {
+    const std::string mode = argc > 1 ? argv[1] : "";
+    if (mode == "record") {
+        std::map<std::string, std::string> options = {
+            {"out", "run.traj"}, {"width", "512"}, {"height", "512"}, {"generations", "1000"}, {"interval", "1"},
+            {"seed", "1"}, {"birth", "0.275"}, {"survival", "0.8"}, {"near_weight", "0.5"}, {"far_weight", "0.5"},
+            {"tile", "64"}, {"block", "32"}, {"threads", std::to_string(std::max(1u, std::thread::hardware_concurrency()))},
+            {"probe", ""}, {"probe_out", "probe.csv"},
+        };
+        return ParseOptions(argc, argv, 2, options) ? Record(options) : 1;
+    }
+    if (mode == "query") {
+        std::map<std::string, std::string> options = {
+            {"file", "run.traj"}, {"x", "0"}, {"y", "0"}, {"width", "16"}, {"height", "16"},
+            {"from", "0"}, {"to", ""}, {"mmap", "0"}, {"sum", "0"},
+        };
+        return ParseOptions(argc, argv, 2, options) ? Query(options) : 1;
+    }
+    std::cerr << "Usage: " << argv[0] << " record|query [key=value ...]\n";
+    return 1;
+}
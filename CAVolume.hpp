@@ -0,0 +1,212 @@
+// File: CAVolume.hpp
+// Created on: October 18th, 2026
+
+// A 3D version of the continuous automaton on a toroidal volume. It uses
+// the same near/distant averaging scheme as the 2D grid, with 3x3x3 and
+// 7x7x7 cubes in place of the 3x3 and 7x7 squares.
+
+#ifndef CA_VOLUME_HPP
+#define CA_VOLUME_HPP
+
+#include "emp/math/Random.hpp" // Include random number generation utilities
+#include "ThreadPool.hpp"      // Include the thread pool that parallelizes each generation
+#include "CARules.hpp"         // Include the update rules shared with the 2D grid
+#include "GridTiling.hpp"      // Include the coordinate wrapping shared by every grid
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A toroidal 3D grid of continuous cells.
+ *
+ * Cells are stored slab by slab (z outermost, x innermost). Each generation
+ * computes both cube sums with separable box filters, one pass per axis, so
+ * a 7x7x7 neighborhood costs 21 additions per cell instead of 343. Every
+ * pass and the rule update split the slabs between the threads of a pool.
+ */
+class CAVolume {
+
+    int w; // Number of cells along x
+    int h; // Number of cells along y
+    int d; // Number of cells along z
+
+    std::vector<float> cells;   // Current generation
+    std::vector<float> scratch; // Intermediate pass results, then the next generation
+    std::vector<float> nearSum; // 3x3x3 cube sums, including the cell itself
+    std::vector<float> farSum;  // 7x7x7 cube sums, including the cell itself
+
+    ThreadPool & pool;
+
+    public:
+
+    // Rule parameters, with the same meaning and defaults as the 2D rules
+    double birth = 0.275;
+    double survival = 0.8;
+    float nearWeight = 0.5f;
+    float farWeight = 0.5f;
+
+    /**
+     * @brief Allocates every buffer the volume will ever need.
+     *
+     * @param width Number of cells along x.
+     * @param height Number of cells along y.
+     * @param depth Number of cells along z.
+     * @param threads The pool used to parallelize each generation.
+     */
+    CAVolume(int width, int height, int depth, ThreadPool & threads)
+        : w(width), h(height), d(depth), pool(threads) {
+        const size_t cellCount = size_t(w) * h * d;
+        cells.assign(cellCount, 0);
+        scratch.assign(cellCount, 0);
+        nearSum.assign(cellCount, 0);
+        farSum.assign(cellCount, 0);
+    }
+
+    int GetWidth() const { return w; }
+    int GetHeight() const { return h; }
+    int GetDepth() const { return d; }
+
+    /**
+     * @brief Converts coordinates into an index into the flat buffers, wrapping around.
+     */
+    size_t Index(int x, int y, int z) const {
+        return (size_t(Wrap(z, d)) * h + Wrap(y, h)) * w + Wrap(x, w);
+    }
+
+    float Get(int x, int y, int z) const { return cells[Index(x, y, z)]; }
+    void Set(int x, int y, int z, float value) { cells[Index(x, y, z)] = value; }
+
+    /**
+     * @brief Stamps a glider extruded through two layers of the volume.
+     *
+     * The cross-section is the page's 2D glider in orientation 0 (see
+     * CAAnimator::GliderPlacement), placed on layers z and z + 1.
+     */
+    void MakeGlider(int x, int y, int z) {
+        static constexpr int shape[7][2] = { {0, 0}, {1, 0}, {0, 1}, {1, 1}, {-1, -1}, {-2, -2}, {-3, -3} };
+        for (int layer = z; layer <= z + 1; layer++) {
+            for (const auto & offset : shape) {
+                Set(x + offset[0], y + offset[1], layer, 1);
+            }
+        }
+    }
+
+    /**
+     * @brief Seeds the volume with randomly placed extruded gliders.
+     *
+     * @param count The number of gliders to place.
+     * @param random The random number generator to draw positions from.
+     */
+    void SeedGliders(size_t count, emp::Random & random) {
+        for (size_t k = 0; k < count; k++) {
+            MakeGlider(random.GetInt(0, w), random.GetInt(0, h), random.GetInt(0, d));
+        }
+    }
+
+    /**
+     * @brief Copies one z-slice into a 2D grid laid out like CAAnimator's cells.
+     *
+     * @param z The slice to copy.
+     * @param out The destination, indexed x * height + y.
+     */
+    void CopySlice(int z, std::vector<float> & out) const {
+        const float * slab = cells.data() + size_t(Wrap(z, d)) * h * w;
+        for (int x = 0; x < w; x++) {
+            for (int y = 0; y < h; y++) {
+                out[size_t(x) * h + y] = slab[size_t(y) * w + x];
+            }
+        }
+    }
+
+    /**
+     * @brief Computes the next generation of the volume.
+     *
+     * The same rules as the 2D automaton are applied, with the near average
+     * taken over the 26 cells of the 3x3x3 cube and the distant average over
+     * the 342 cells of the 7x7x7 cube around each cell.
+     */
+    void Step() {
+        BoxSum(1, nearSum);
+        BoxSum(3, farSum);
+
+        pool.ParallelFor(0, d, [this](int begin, int end) {
+            const size_t slab = size_t(w) * h;
+            for (size_t k = begin * slab; k < end * slab; k++) {
+                float self = cells[k];
+                float nearAvg = (nearSum[k] - self) / 26;
+                float farAvg = (farSum[k] - self) / 342;
+                float allNeighborsAvg = nearWeight * nearAvg + farWeight * farAvg;
+
+                // The same rules as the 2D grid
+                scratch[k] = ApplyRules(self, allNeighborsAvg, birth, survival);
+            }
+        });
+
+        std::swap(cells, scratch);
+    }
+
+    private:
+
+    /**
+     * @brief Sums every (2 * radius + 1)^3 cube of cells, wrapping around the volume.
+     *
+     * Three separable passes: along x (cells -> out), along y (out -> scratch)
+     * and along z (scratch -> out). The y and z passes add whole rows and
+     * slabs at a time, so their inner loops run over contiguous memory.
+     *
+     * @param radius The cube's radius.
+     * @param out Receives the sums; must hold one float per cell.
+     */
+    void BoxSum(int radius, std::vector<float> & out) {
+        const size_t row = size_t(w);
+        const size_t slab = size_t(w) * h;
+
+        // Pass 1: along x, within each row
+        pool.ParallelFor(0, d, [&](int begin, int end) {
+            for (size_t r = begin * size_t(h); r < end * size_t(h); r++) {
+                const float * in = cells.data() + r * row;
+                float * dst = out.data() + r * row;
+                for (int x = 0; x < w; x++) {
+                    float sum = 0;
+                    for (int k = -radius; k <= radius; k++) {
+                        sum += in[Wrap(x + k, w)];
+                    }
+                    dst[x] = sum;
+                }
+            }
+        });
+
+        // Pass 2: along y, adding whole rows within each slab
+        pool.ParallelFor(0, d, [&](int begin, int end) {
+            for (int z = begin; z < end; z++) {
+                for (int y = 0; y < h; y++) {
+                    float * dst = scratch.data() + z * slab + y * row;
+                    std::fill(dst, dst + w, 0.0f);
+                    for (int k = -radius; k <= radius; k++) {
+                        const float * in = out.data() + z * slab + Wrap(y + k, h) * row;
+                        for (int x = 0; x < w; x++) {
+                            dst[x] += in[x];
+                        }
+                    }
+                }
+            }
+        });
+
+        // Pass 3: along z, adding whole slabs
+        pool.ParallelFor(0, d, [&](int begin, int end) {
+            for (int z = begin; z < end; z++) {
+                float * dst = out.data() + z * slab;
+                std::fill(dst, dst + slab, 0.0f);
+                for (int k = -radius; k <= radius; k++) {
+                    const float * in = scratch.data() + Wrap(z + k, d) * slab;
+                    for (size_t c = 0; c < slab; c++) {
+                        dst[c] += in[c];
+                    }
+                }
+            }
+        });
+    }
+};
+
+#endif
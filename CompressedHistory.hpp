@@ -0,0 +1,281 @@
+// File: CompressedHistory.hpp
+// Created on: October 18th, 2026
+
+// A history ring that keeps thousands of past generations in a fixed memory
+// budget. States are quantized, each frame is XORed with the one before it
+// so unchanged cells become zeros, and the result is run-length and varint
+// coded. Every few frames a keyframe is coded against an empty grid instead,
+// so any frame can be rebuilt from the keyframe before it.
+
+#ifndef COMPRESSED_HISTORY_HPP
+#define COMPRESSED_HISTORY_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Compressed frames of a grid of states in [0, 1], newest last, within a byte budget.
+ *
+ * All memory is allocated by the constructor. When a new frame doesn't fit,
+ * the oldest keyframe is dropped together with the frames coded against it.
+ */
+class CompressedHistory {
+
+    struct FrameInfo {
+        size_t offset;     // Where its bytes start in the arena
+        size_t size;       // How many bytes it takes
+        size_t generation;
+        bool key;          // Coded against an empty grid rather than the frame before
+    };
+
+    size_t cellCount;
+    int keyframeInterval;
+    float levels; // Largest quantized value
+
+    std::vector<uint8_t> arena;   // Ring of encoded frames
+    size_t tail = 0;              // Where the next frame's bytes go
+    std::vector<FrameInfo> infos; // Ring of frame descriptions
+    size_t first = 0;             // Slot of the oldest frame
+    size_t count = 0;
+    size_t sinceKey = 0;          // Frames pushed since the last keyframe
+
+    std::vector<uint16_t> previous; // The newest frame, quantized
+    std::vector<uint16_t> current;  // Scratch: the frame being pushed, quantized
+    std::vector<uint8_t> encoded;   // Scratch: the frame being pushed, encoded
+
+    // Decoding cache, so scrubbing forward from a decoded frame only applies the deltas in between
+    std::vector<uint16_t> decoded;
+    size_t decodedGeneration = 0;
+    bool decodedValid = false;
+
+    public:
+
+    /**
+     * @brief Allocates the ring.
+     *
+     * @param cells The number of cells in a frame.
+     * @param budgetBytes Memory for encoded frames. Their descriptions take an eighth
+     * more, which limits the ring to one frame per 256 bytes of budget.
+     * @param keyframeEvery A keyframe is coded every this many frames.
+     * @param bits Bits per quantized state, at most 16; the largest error is half a quantization step.
+     */
+    CompressedHistory(size_t cells, size_t budgetBytes, int keyframeEvery = 32, int bits = 8)
+        : cellCount(cells), keyframeInterval(std::max(keyframeEvery, 1)),
+          levels(float((1u << std::clamp(bits, 1, 16)) - 1)) {
+        // The worst case is a run header per cell and three varint bytes per value
+        encoded.resize(cellCount * 5 + 16);
+        arena.resize(std::max(budgetBytes, encoded.size()));
+        infos.resize(arena.size() / 256 + 2);
+        previous.assign(cellCount, 0);
+        current.assign(cellCount, 0);
+        decoded.assign(cellCount, 0);
+    }
+
+    size_t Frames() const { return count; }
+    size_t Generation(size_t k) const { return Info(k).generation; }
+    size_t BudgetBytes() const { return arena.size(); }
+    float MaxError() const { return 0.5f / levels; }
+
+    /**
+     * @brief Bytes taken by the encoded frames held.
+     */
+    size_t UsedBytes() const {
+        size_t total = 0;
+        for (size_t k = 0; k < count; k++) {
+            total += Info(k).size;
+        }
+        return total;
+    }
+
+    void Clear() {
+        count = 0;
+        first = 0;
+        tail = 0;
+        sinceKey = 0;
+        decodedValid = false;
+    }
+
+    /**
+     * @brief Appends a frame; generations must increase from frame to frame.
+     */
+    void Push(const float * cells, size_t generation) {
+        for (size_t c = 0; c < cellCount; c++) {
+            current[c] = uint16_t(std::lround(std::clamp(cells[c], 0.0f, 1.0f) * levels));
+        }
+
+        bool key = count == 0 || sinceKey + 1 >= size_t(keyframeInterval);
+        size_t size = Encode(key);
+        if (!MakeRoom(size)) {
+            // Making room dropped the keyframe this frame depended on
+            key = true;
+            size = Encode(key);
+            MakeRoom(size);
+        }
+
+        const size_t slot = (first + count) % infos.size();
+        std::copy(encoded.begin(), encoded.begin() + std::ptrdiff_t(size), arena.begin() + std::ptrdiff_t(tail));
+        infos[slot] = FrameInfo{tail, size, generation, key};
+        tail += size;
+        count++;
+        sinceKey = key ? 0 : sinceKey + 1;
+        previous.swap(current);
+    }
+
+    /**
+     * @brief Rebuilds the k-th oldest frame held.
+     *
+     * Decodes from the nearest keyframe at or before it, or continues from
+     * the last frame decoded when that is closer, so stepping through
+     * frames in either direction stays cheap.
+     */
+    void Decode(size_t k, float * out) {
+        size_t start = k;
+        while (!Info(start).key) {
+            start--;
+        }
+        size_t from = start;
+        if (decodedValid) {
+            // Reuse the last decoded frame if it lies between the keyframe and the target
+            for (size_t j = start; j <= k; j++) {
+                if (Info(j).generation == decodedGeneration) {
+                    from = j + 1;
+                    break;
+                }
+            }
+        }
+        if (from == start) {
+            std::fill(decoded.begin(), decoded.end(), 0);
+        }
+        for (size_t j = from; j <= k; j++) {
+            Apply(Info(j));
+        }
+        decodedGeneration = Info(k).generation;
+        decodedValid = true;
+
+        const float scale = 1.0f / levels;
+        for (size_t c = 0; c < cellCount; c++) {
+            out[c] = float(decoded[c]) * scale;
+        }
+    }
+
+    private:
+
+    const FrameInfo & Info(size_t k) const { return infos[(first + k) % infos.size()]; }
+
+    /**
+     * @brief Codes `current` XOR the base frame into `encoded` as runs of zeros and of values.
+     *
+     * Each run pair is two varints, the number of zeros then the number of
+     * values, followed by the values as varints.
+     *
+     * @return The number of bytes used.
+     */
+    size_t Encode(bool key) {
+        uint8_t * out = encoded.data();
+        size_t c = 0;
+        while (c < cellCount) {
+            size_t zeros = 0;
+            while (c + zeros < cellCount && current[c + zeros] == (key ? 0 : previous[c + zeros])) {
+                zeros++;
+            }
+            size_t values = 0;
+            while (c + zeros + values < cellCount &&
+                   current[c + zeros + values] != (key ? 0 : previous[c + zeros + values])) {
+                values++;
+            }
+            out = PutVarint(out, zeros);
+            out = PutVarint(out, values);
+            for (size_t v = c + zeros; v < c + zeros + values; v++) {
+                out = PutVarint(out, key ? current[v] : uint16_t(current[v] ^ previous[v]));
+            }
+            c += zeros + values;
+        }
+        return size_t(out - encoded.data());
+    }
+
+    /**
+     * @brief Applies one encoded frame to `decoded`.
+     */
+    void Apply(const FrameInfo & info) {
+        const uint8_t * in = arena.data() + info.offset;
+        size_t c = 0;
+        while (c < cellCount) {
+            const size_t zeros = GetVarint(in);
+            const size_t values = GetVarint(in);
+            if (info.key) {
+                std::fill(decoded.begin() + std::ptrdiff_t(c), decoded.begin() + std::ptrdiff_t(c + zeros), 0);
+            }
+            c += zeros;
+            for (size_t v = 0; v < values; v++, c++) {
+                const uint16_t value = uint16_t(GetVarint(in));
+                decoded[c] = info.key ? value : uint16_t(decoded[c] ^ value);
+            }
+        }
+    }
+
+    /**
+     * @brief Frees a contiguous stretch of `size` bytes at `tail`, dropping the oldest frames.
+     *
+     * Frames are dropped a keyframe and its dependents at a time.
+     *
+     * @return False if the frames dropped included the newest one.
+     */
+    bool MakeRoom(size_t size) {
+        bool keptNewest = true;
+        if (tail + size > arena.size()) {
+            // Not enough left before the end of the arena: wrap around
+            while (count > 0 && Info(0).offset >= tail) {
+                keptNewest = DropOldestSegment() && keptNewest;
+            }
+            tail = 0;
+        }
+        while (count > 0 && (Overlaps(Info(0), size) || count == infos.size())) {
+            keptNewest = DropOldestSegment() && keptNewest;
+        }
+        if (count == 0) {
+            tail = 0;
+        }
+        return keptNewest;
+    }
+
+    bool Overlaps(const FrameInfo & info, size_t size) const {
+        return info.offset < tail + size && tail < info.offset + info.size;
+    }
+
+    /**
+     * @return False if the segment dropped was the newest one.
+     */
+    bool DropOldestSegment() {
+        do {
+            first = (first + 1) % infos.size();
+            count--;
+        } while (count > 0 && !Info(0).key);
+        decodedValid = false;
+        return count > 0;
+    }
+
+    static uint8_t * PutVarint(uint8_t * out, size_t value) {
+        while (value >= 0x80) {
+            *out++ = uint8_t(value | 0x80);
+            value >>= 7;
+        }
+        *out++ = uint8_t(value);
+        return out;
+    }
+
+    static size_t GetVarint(const uint8_t * & in) {
+        size_t value = 0;
+        int shift = 0;
+        while (*in & 0x80) {
+            value |= size_t(*in++ & 0x7F) << shift;
+            shift += 7;
+        }
+        value |= size_t(*in++) << shift;
+        return value;
+    }
+};
+
+#endif
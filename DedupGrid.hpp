@@ -0,0 +1,348 @@
+// File: DedupGrid.hpp
+// Created on: October 18th, 2026
+
+// Tiled storage for the 2D automaton in which identical tiles are stored
+// once. Tile contents are immutable and interned by hash, so all-zero tiles
+// and repeating patterns share one copy; changing a cell copies its tile
+// first. Since a tile's next state depends only on the 3x3 block of tiles
+// around it, each distinct block is stepped once and the result is shared.
+
+#ifndef DEDUP_GRID_HPP
+#define DEDUP_GRID_HPP
+
+#include "ThreadPool.hpp" // Include the thread pool that parallelizes each generation
+#include "CARules.hpp"    // Include the neighborhood average shared by every stepper
+#include "GridTiling.hpp" // Include the tile layout shared with the other tiled grid
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A toroidal 2D grid of shared, content-addressed tiles.
+ *
+ * Tiles are at most 32x32 cells, split as evenly as possible like
+ * SparseGrid's, so no tile is narrower than the distant neighborhood radius
+ * on grids of at least 3 cells per side. Each tile content gets an id when
+ * first stored; the result of stepping a tile is remembered under the ids
+ * of the 9 tiles around it and reused whenever that block recurs, in the
+ * same generation or a later one. Cells are computed in the same order of
+ * floating-point operations as CAAnimator::NextState, so results match the
+ * synchronous stepper exactly.
+ */
+class DedupGrid {
+
+    static constexpr int maxTile = 32;
+
+    /**
+     * @brief One immutable tile content.
+     */
+    struct TileData {
+        uint64_t id;
+        int tw;
+        int th;
+        std::vector<float> values; // Indexed x * th + y
+    };
+    using TileRef = std::shared_ptr<const TileData>;
+    using BlockKey = std::array<uint64_t, 9>; // Ids of the 3x3 tiles around one tile
+
+    struct BlockKeyHash {
+        size_t operator()(const BlockKey & key) const {
+            uint64_t h = 0x9E3779B97F4A7C15ull;
+            for (uint64_t id : key) {
+                h = (h ^ id) * 0xBF58476D1CE4E5B9ull;
+                h ^= h >> 31;
+            }
+            return size_t(h);
+        }
+    };
+
+    int w;
+    int h;
+    TileLayout layout;
+
+    std::vector<TileRef> tiles;
+    std::vector<TileRef> nextTiles;
+
+    // Every live tile content, by hash; entries expire when no grid or memo refers to them
+    std::unordered_multimap<uint64_t, std::weak_ptr<const TileData>> store;
+    std::mutex storeMutex;
+    uint64_t nextId = 1;
+
+    // Step results by the block of tiles they came from
+    std::unordered_map<BlockKey, TileRef, BlockKeyHash> memo;
+    std::mutex memoMutex;
+    size_t memoHits = 0;
+    size_t tilesComputed = 0;
+
+    ThreadPool & pool;
+
+    public:
+
+    /**
+     * @brief Creates an all-zero grid, which stores a single tile per tile size.
+     *
+     * @param width Number of cells along x.
+     * @param height Number of cells along y.
+     * @param threads The pool used to parallelize each generation.
+     */
+    DedupGrid(int width, int height, ThreadPool & threads)
+        : w(width), h(height), layout(width, height, maxTile), pool(threads) {
+        tiles.resize(layout.Count());
+        nextTiles.resize(tiles.size());
+        LoadDense(std::vector<float>(size_t(w) * h, 0.0f));
+    }
+
+    /**
+     * @brief Replaces the contents with a dense grid laid out like CAAnimator's cells.
+     *
+     * @param cells The grid, indexed x * height + y.
+     */
+    void LoadDense(const std::vector<float> & cells) {
+        pool.ParallelFor(0, layout.tilesW, [&](int begin, int end) {
+            std::vector<float> block;
+            for (int tx = begin; tx < end; tx++) {
+                for (int ty = 0; ty < layout.tilesH; ty++) {
+                    const int x0 = layout.StartX(tx);
+                    const int y0 = layout.StartY(ty);
+                    const int tw = layout.StartX(tx + 1) - x0;
+                    const int th = layout.StartY(ty + 1) - y0;
+                    block.resize(size_t(tw) * th);
+                    for (int x = 0; x < tw; x++) {
+                        const float * column = cells.data() + size_t(x0 + x) * h + y0;
+                        std::copy(column, column + th, block.begin() + std::ptrdiff_t(x * th));
+                    }
+                    tiles[layout.Index(tx, ty)] = Intern(std::move(block), tw, th);
+                }
+            }
+        });
+        Collect();
+    }
+
+    /**
+     * @brief Writes the contents out as a dense grid laid out like CAAnimator's cells.
+     *
+     * @param cells The destination, indexed x * height + y; must hold every cell.
+     */
+    void StoreDense(std::vector<float> & cells) const {
+        pool.ParallelFor(0, layout.tilesW, [&](int begin, int end) {
+            for (int tx = begin; tx < end; tx++) {
+                for (int ty = 0; ty < layout.tilesH; ty++) {
+                    const TileData & tile = *tiles[layout.Index(tx, ty)];
+                    const int x0 = layout.StartX(tx);
+                    const int y0 = layout.StartY(ty);
+                    for (int x = 0; x < tile.tw; x++) {
+                        const float * column = tile.values.data() + size_t(x) * tile.th;
+                        std::copy(column, column + tile.th, cells.data() + size_t(x0 + x) * h + y0);
+                    }
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Reads one cell, wrapping around the grid.
+     */
+    float Get(int x, int y) const {
+        x = Wrap(x, w);
+        y = Wrap(y, h);
+        const int tx = layout.OfX(x);
+        const int ty = layout.OfY(y);
+        const TileData & tile = *tiles[layout.Index(tx, ty)];
+        return tile.values[size_t(x - layout.StartX(tx)) * tile.th + (y - layout.StartY(ty))];
+    }
+
+    /**
+     * @brief Writes one cell, wrapping around the grid.
+     *
+     * The tile may be shared, so it is copied, changed and stored again
+     * rather than changed in place.
+     */
+    void Set(int x, int y, float value) {
+        x = Wrap(x, w);
+        y = Wrap(y, h);
+        const int tx = layout.OfX(x);
+        const int ty = layout.OfY(y);
+        TileRef & tile = tiles[layout.Index(tx, ty)];
+        std::vector<float> values = tile->values;
+        values[size_t(x - layout.StartX(tx)) * tile->th + (y - layout.StartY(ty))] = value;
+        tile = Intern(std::move(values), tile->tw, tile->th);
+    }
+
+    size_t TileCount() const { return tiles.size(); }
+
+    /**
+     * @brief The number of distinct tile contents in the current grid.
+     */
+    size_t UniqueTiles() const {
+        std::vector<const TileData *> distinct;
+        distinct.reserve(tiles.size());
+        for (const TileRef & tile : tiles) {
+            distinct.push_back(tile.get());
+        }
+        std::sort(distinct.begin(), distinct.end());
+        return size_t(std::unique(distinct.begin(), distinct.end()) - distinct.begin());
+    }
+
+    /**
+     * @brief Tiles computed and tiles taken from remembered results, over all steps so far.
+     */
+    size_t TilesComputed() const { return tilesComputed; }
+    size_t MemoHits() const { return memoHits; }
+
+    /**
+     * @brief Forgets every remembered step result; call it whenever the rule changes.
+     */
+    void ClearMemo() {
+        std::lock_guard<std::mutex> lock(memoMutex);
+        memo.clear();
+    }
+
+    /**
+     * @brief Computes the next generation.
+     *
+     * @param rule Called as rule(self, nearAvg, distAvg, x, y) for every cell
+     *        of a tile being computed; returns its next state.
+     * @param memoize Whether results may be shared between identical blocks
+     *        of tiles. Only valid if the rule ignores x and y.
+     */
+    template <typename RULE>
+    void Step(RULE && rule, bool memoize) {
+        pool.ParallelFor(0, layout.tilesW, [&](int begin, int end) {
+            std::vector<float> padded((maxTile + 6) * (maxTile + 6));
+            size_t computed = 0;
+            size_t hits = 0;
+            for (int tx = begin; tx < end; tx++) {
+                for (int ty = 0; ty < layout.tilesH; ty++) {
+                    BlockKey key;
+                    for (int a = -1; a <= 1; a++) {
+                        for (int b = -1; b <= 1; b++) {
+                            key[size_t((a + 1) * 3 + b + 1)] = tiles[layout.Index(tx + a, ty + b)]->id;
+                        }
+                    }
+                    TileRef & out = nextTiles[layout.Index(tx, ty)];
+                    if (memoize) {
+                        std::lock_guard<std::mutex> lock(memoMutex);
+                        auto found = memo.find(key);
+                        if (found != memo.end()) {
+                            out = found->second;
+                            hits++;
+                            continue;
+                        }
+                    }
+
+                    out = StepTile(tx, ty, padded, rule);
+                    computed++;
+                    if (memoize) {
+                        std::lock_guard<std::mutex> lock(memoMutex);
+                        memo.emplace(key, out);
+                    }
+                }
+            }
+            std::lock_guard<std::mutex> lock(memoMutex);
+            tilesComputed += computed;
+            memoHits += hits;
+        });
+        std::swap(tiles, nextTiles);
+
+        // Remembered results keep their tiles alive, so the memo is bounded by
+        // the grid's size; past that it starts over
+        if (memo.size() > 4 * tiles.size()) {
+            memo.clear();
+        }
+        Collect();
+    }
+
+    private:
+
+    /**
+     * @brief Returns the stored tile with these contents, storing them if they are new.
+     */
+    TileRef Intern(std::vector<float> && values, int tw, int th) {
+        uint64_t hash = 0xCBF29CE484222325ull ^ (uint64_t(tw) << 32 | uint64_t(th));
+        for (float value : values) {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            hash = (hash ^ bits) * 0x100000001B3ull;
+        }
+
+        std::lock_guard<std::mutex> lock(storeMutex);
+        auto range = store.equal_range(hash);
+        for (auto entry = range.first; entry != range.second; ++entry) {
+            TileRef existing = entry->second.lock();
+            // Compare contents bit for bit: a hash match alone could be a collision
+            if (existing && existing->tw == tw && existing->th == th &&
+                std::memcmp(existing->values.data(), values.data(), values.size() * sizeof(float)) == 0) {
+                return existing;
+            }
+        }
+        auto tile = std::make_shared<const TileData>(TileData{nextId++, tw, th, std::move(values)});
+        store.emplace(hash, tile);
+        return tile;
+    }
+
+    /**
+     * @brief Drops store entries whose tiles are no longer referenced.
+     */
+    void Collect() {
+        for (auto entry = store.begin(); entry != store.end();) {
+            entry = entry->second.expired() ? store.erase(entry) : std::next(entry);
+        }
+    }
+
+    /**
+     * @brief Computes one tile from the 3-cell border of its neighbors.
+     *
+     * The tile and the border are first copied into `padded`, so every
+     * neighborhood is read without wrapping; the additions then go through
+     * the shared NeighborhoodAvg like every other stepper.
+     */
+    template <typename RULE>
+    TileRef StepTile(int tx, int ty, std::vector<float> & padded, RULE & rule) {
+        const TileData & center = *tiles[layout.Index(tx, ty)];
+        const int tw = center.tw;
+        const int th = center.th;
+        const int ph = th + 6;
+
+        for (int a = -1; a <= 1; a++) {
+            const TileData & columnTile = *tiles[layout.Index(tx + a, ty)];
+            // Which of this neighbor's columns the border takes, and where they go
+            const int sx0 = a < 0 ? columnTile.tw - 3 : 0;
+            const int sx1 = a == 0 ? tw : (a < 0 ? columnTile.tw : 3);
+            const int px0 = a < 0 ? 0 : (a == 0 ? 3 : tw + 3);
+            for (int b = -1; b <= 1; b++) {
+                const TileData & source = *tiles[layout.Index(tx + a, ty + b)];
+                const int sy0 = b < 0 ? source.th - 3 : 0;
+                const int sy1 = b == 0 ? th : (b < 0 ? source.th : 3);
+                const int py0 = b < 0 ? 0 : (b == 0 ? 3 : th + 3);
+                for (int sx = sx0; sx < sx1; sx++) {
+                    const float * column = source.values.data() + size_t(sx) * source.th;
+                    std::copy(column + sy0, column + sy1, padded.begin() + std::ptrdiff_t((px0 + sx - sx0) * ph + py0));
+                }
+            }
+        }
+
+        const int x0 = layout.StartX(tx);
+        const int y0 = layout.StartY(ty);
+        const auto paddedCell = [&](int i, int j) { return padded[size_t(i) * ph + j]; };
+        std::vector<float> values(size_t(tw) * th);
+        for (int x = 0; x < tw; x++) {
+            for (int y = 0; y < th; y++) {
+                const int px = x + 3;
+                const int py = y + 3;
+                const float nearAvg = NeighborhoodAvg(px, py, 1, paddedCell);
+                const float distAvg = NeighborhoodAvg(px, py, 3, paddedCell);
+                values[size_t(x) * th + y] = rule(padded[size_t(px) * ph + py], nearAvg, distAvg, x0 + x, y0 + y);
+            }
+        }
+        return Intern(std::move(values), tw, th);
+    }
+};
+
+#endif
@@ -0,0 +1,350 @@
+// File: Ensemble.hpp
+// Created on: October 18th, 2026
+
+// Streaming statistics over ensembles of runs. Each run is folded into an
+// EnsembleAggregator as it finishes and then forgotten, and aggregators
+// from different workers merge, so the memory used depends on the length of
+// the runs but never on how many there were.
+
+#ifndef ENSEMBLE_HPP
+#define ENSEMBLE_HPP
+
+#include "Termination.hpp" // Include the reasons a run can stop early
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Count, mean, variance and range of a stream of values (Welford's method).
+ */
+struct RunningStats {
+    uint64_t count = 0;
+    double mean = 0;
+    double m2 = 0; // Sum of squared differences from the mean
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void Add(double value) {
+        count++;
+        const double delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    /**
+     * @brief Combines with statistics of another stream (Chan et al.'s pairwise update).
+     */
+    void Merge(const RunningStats & other) {
+        if (other.count == 0) {
+            return;
+        }
+        const uint64_t total = count + other.count;
+        const double delta = other.mean - mean;
+        mean += delta * other.count / total;
+        m2 += other.m2 + delta * delta * (double(count) * other.count / total);
+        count = total;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    double Variance() const { return count > 1 ? m2 / (count - 1) : 0; }
+};
+
+/**
+ * @brief A mergeable sketch of a distribution that answers quantile queries (a KLL sketch).
+ *
+ * Values are kept in levels; a value at level h stands for 2^h values of
+ * the stream. When a level outgrows its capacity it is sorted and every
+ * other value (starting at a pseudo-random offset) moves up a level. Lower
+ * levels get geometrically smaller capacities, so the sketch holds about
+ * 3k values however long the stream is, with rank error around 1.7 / k.
+ */
+class QuantileSketch {
+
+    int k;
+    std::vector<std::vector<double>> levels;
+    uint64_t count = 0;
+    uint64_t coin = 0x853C49E6748FEA9Bull; // State of the offset choices, so results are reproducible
+
+    public:
+
+    explicit QuantileSketch(int accuracy = 200) : k(std::max(accuracy, 8)), levels(1) { }
+
+    uint64_t Count() const { return count; }
+
+    void Add(double value) {
+        levels[0].push_back(value);
+        count++;
+        Compress();
+    }
+
+    void Merge(const QuantileSketch & other) {
+        if (levels.size() < other.levels.size()) {
+            levels.resize(other.levels.size());
+        }
+        for (size_t h = 0; h < other.levels.size(); h++) {
+            levels[h].insert(levels[h].end(), other.levels[h].begin(), other.levels[h].end());
+        }
+        count += other.count;
+        Compress();
+    }
+
+    /**
+     * @brief An estimate of the value at rank q * Count(), for q in [0, 1]; NaN if empty.
+     */
+    double Quantile(double q) const {
+        std::vector<std::pair<double, uint64_t>> weighted;
+        uint64_t total = 0;
+        for (size_t h = 0; h < levels.size(); h++) {
+            for (double value : levels[h]) {
+                weighted.emplace_back(value, uint64_t(1) << h);
+                total += uint64_t(1) << h;
+            }
+        }
+        if (weighted.empty()) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        std::sort(weighted.begin(), weighted.end());
+        const double target = std::clamp(q, 0.0, 1.0) * total;
+        uint64_t seen = 0;
+        for (const auto & entry : weighted) {
+            seen += entry.second;
+            if (seen >= target) {
+                return entry.first;
+            }
+        }
+        return weighted.back().first;
+    }
+
+    void Save(std::ostream & out) const {
+        const uint64_t header[4] = { uint64_t(k), count, coin, uint64_t(levels.size()) };
+        out.write(reinterpret_cast<const char *>(header), sizeof(header));
+        for (const auto & level : levels) {
+            const uint64_t size = level.size();
+            out.write(reinterpret_cast<const char *>(&size), sizeof(size));
+            out.write(reinterpret_cast<const char *>(level.data()), std::streamsize(size * sizeof(double)));
+        }
+    }
+
+    bool Load(std::istream & in) {
+        uint64_t header[4];
+        if (!in.read(reinterpret_cast<char *>(header), sizeof(header)) || header[3] > 64) {
+            return false;
+        }
+        std::vector<std::vector<double>> loaded(header[3]);
+        for (auto & level : loaded) {
+            uint64_t size;
+            if (!in.read(reinterpret_cast<char *>(&size), sizeof(size)) || size > (uint64_t(1) << 32)) {
+                return false;
+            }
+            level.resize(size);
+            if (!in.read(reinterpret_cast<char *>(level.data()), std::streamsize(size * sizeof(double)))) {
+                return false;
+            }
+        }
+        k = int(header[0]);
+        count = header[1];
+        coin = header[2];
+        levels = std::move(loaded);
+        if (levels.empty()) {
+            levels.resize(1);
+        }
+        return true;
+    }
+
+    private:
+
+    size_t Capacity(size_t level) const {
+        // The top level holds k values, each level below two thirds as many
+        const double depth = double(levels.size() - 1 - level);
+        return std::max<size_t>(2, size_t(k * std::pow(2.0 / 3.0, depth)));
+    }
+
+    void Compress() {
+        for (size_t h = 0; h < levels.size(); h++) {
+            if (levels[h].size() <= Capacity(h)) {
+                continue;
+            }
+            if (h + 1 == levels.size()) {
+                levels.emplace_back();
+            }
+            std::vector<double> & level = levels[h];
+            std::sort(level.begin(), level.end());
+
+            // An odd value out stays behind so the promoted weight is exact
+            double leftover = 0;
+            const bool odd = level.size() % 2;
+            if (odd) {
+                leftover = level.back();
+                level.pop_back();
+            }
+            coin = GridStats::Mix(coin + 0x9E3779B97F4A7C15ull);
+            for (size_t i = coin & 1; i < level.size(); i += 2) {
+                levels[h + 1].push_back(level[i]);
+            }
+            level.clear();
+            if (odd) {
+                level.push_back(leftover);
+            }
+        }
+    }
+};
+
+/**
+ * @brief Aggregate curves and final-state distributions over many runs.
+ *
+ * Curves are the live fraction and mean state sampled every `interval`
+ * generations. A run that stopped early holds its last sample for the rest
+ * of the curve; it stopped because it died out, filled up, froze or
+ * started cycling, so its last state stands for the ones it skipped.
+ */
+class EnsembleAggregator {
+
+    size_t interval;
+    size_t samples;                      // Points on each curve
+    std::vector<RunningStats> liveCurve; // Live fraction at each sampled generation
+    std::vector<RunningStats> meanCurve; // Mean state at each sampled generation
+    RunningStats generationsRun;
+    RunningStats finalLive;
+    RunningStats finalMean;
+    QuantileSketch finalLiveQuantiles;
+    QuantileSketch finalMeanQuantiles;
+    std::vector<uint64_t> reasons;       // Runs per TerminationReason
+
+    public:
+
+    /**
+     * @param generations The length of the runs.
+     * @param sampleInterval Generations between curve points.
+     */
+    EnsembleAggregator(size_t generations, size_t sampleInterval)
+        : interval(std::max<size_t>(sampleInterval, 1)), samples(generations / std::max<size_t>(sampleInterval, 1)),
+          liveCurve(samples), meanCurve(samples), reasons(size_t(TerminationReason::PopulationBand) + 1, 0) { }
+
+    size_t Interval() const { return interval; }
+    uint64_t Runs() const { return generationsRun.count; }
+
+    /**
+     * @brief Folds in one finished run.
+     *
+     * @param live The run's live fraction every `interval` generations, for as long as it ran.
+     * @param mean Its mean state at the same generations.
+     * @param generations How many generations it ran.
+     * @param finalLiveFraction Its live fraction when it stopped.
+     * @param finalMeanState Its mean state when it stopped.
+     * @param reason Why it stopped.
+     */
+    void AddRun(const std::vector<float> & live, const std::vector<float> & mean, size_t generations,
+                double finalLiveFraction, double finalMeanState, TerminationReason reason) {
+        for (size_t k = 0; k < samples; k++) {
+            liveCurve[k].Add(k < live.size() ? live[k] : finalLiveFraction);
+            meanCurve[k].Add(k < mean.size() ? mean[k] : finalMeanState);
+        }
+        generationsRun.Add(double(generations));
+        finalLive.Add(finalLiveFraction);
+        finalMean.Add(finalMeanState);
+        finalLiveQuantiles.Add(finalLiveFraction);
+        finalMeanQuantiles.Add(finalMeanState);
+        reasons[size_t(reason)]++;
+    }
+
+    /**
+     * @brief Combines with an aggregator built over other runs with the same settings.
+     */
+    void Merge(const EnsembleAggregator & other) {
+        for (size_t k = 0; k < samples && k < other.samples; k++) {
+            liveCurve[k].Merge(other.liveCurve[k]);
+            meanCurve[k].Merge(other.meanCurve[k]);
+        }
+        generationsRun.Merge(other.generationsRun);
+        finalLive.Merge(other.finalLive);
+        finalMean.Merge(other.finalMean);
+        finalLiveQuantiles.Merge(other.finalLiveQuantiles);
+        finalMeanQuantiles.Merge(other.finalMeanQuantiles);
+        for (size_t r = 0; r < reasons.size(); r++) {
+            reasons[r] += other.reasons[r];
+        }
+    }
+
+    void Save(std::ostream & out) const {
+        const uint64_t header[2] = { uint64_t(interval), uint64_t(samples) };
+        out.write(reinterpret_cast<const char *>(header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(liveCurve.data()), std::streamsize(samples * sizeof(RunningStats)));
+        out.write(reinterpret_cast<const char *>(meanCurve.data()), std::streamsize(samples * sizeof(RunningStats)));
+        for (const RunningStats * stats : { &generationsRun, &finalLive, &finalMean }) {
+            out.write(reinterpret_cast<const char *>(stats), sizeof(RunningStats));
+        }
+        finalLiveQuantiles.Save(out);
+        finalMeanQuantiles.Save(out);
+        out.write(reinterpret_cast<const char *>(reasons.data()), std::streamsize(reasons.size() * sizeof(uint64_t)));
+    }
+
+    /**
+     * @brief Reads an aggregator written by Save with the same settings.
+     *
+     * @return False, leaving this one unchanged, if the data is truncated or for other settings.
+     */
+    bool Load(std::istream & in) {
+        uint64_t header[2];
+        if (!in.read(reinterpret_cast<char *>(header), sizeof(header)) || header[0] != interval || header[1] != samples) {
+            return false;
+        }
+        EnsembleAggregator loaded(*this);
+        bool ok = bool(in.read(reinterpret_cast<char *>(loaded.liveCurve.data()), std::streamsize(samples * sizeof(RunningStats))));
+        ok = ok && in.read(reinterpret_cast<char *>(loaded.meanCurve.data()), std::streamsize(samples * sizeof(RunningStats)));
+        for (RunningStats * stats : { &loaded.generationsRun, &loaded.finalLive, &loaded.finalMean }) {
+            ok = ok && in.read(reinterpret_cast<char *>(stats), sizeof(RunningStats));
+        }
+        ok = ok && loaded.finalLiveQuantiles.Load(in) && loaded.finalMeanQuantiles.Load(in);
+        ok = ok && in.read(reinterpret_cast<char *>(loaded.reasons.data()), std::streamsize(reasons.size() * sizeof(uint64_t)));
+        if (ok) {
+            *this = std::move(loaded);
+        }
+        return ok;
+    }
+
+    /**
+     * @brief Writes the aggregate curves as CSV: one row per sampled generation.
+     */
+    void WriteCurves(std::ostream & out) const {
+        out << "generation,runs,live_mean,live_variance,live_min,live_max,mean_state_mean,mean_state_variance\n";
+        for (size_t k = 0; k < samples; k++) {
+            out << (k + 1) * interval << "," << liveCurve[k].count << "," << liveCurve[k].mean << ","
+                << liveCurve[k].Variance() << "," << liveCurve[k].min << "," << liveCurve[k].max << ","
+                << meanCurve[k].mean << "," << meanCurve[k].Variance() << "\n";
+        }
+    }
+
+    /**
+     * @brief Writes a readable summary of the final states and of why runs stopped.
+     */
+    void WriteSummary(std::ostream & out) const {
+        out << "runs: " << Runs() << "\n";
+        out << "generations run: mean " << generationsRun.mean << ", min " << generationsRun.min
+            << ", max " << generationsRun.max << "\n";
+        for (size_t r = 0; r < reasons.size(); r++) {
+            out << "stopped by " << DescribeTermination(TerminationReason(r)) << ": " << reasons[r] << "\n";
+        }
+        const std::pair<const char *, const QuantileSketch *> finals[] = {
+            { "final live fraction", &finalLiveQuantiles }, { "final mean state", &finalMeanQuantiles } };
+        const RunningStats * moments[] = { &finalLive, &finalMean };
+        for (int f = 0; f < 2; f++) {
+            out << finals[f].first << ": mean " << moments[f]->mean << ", sd " << std::sqrt(moments[f]->Variance())
+                << ", quantiles";
+            for (double q : { 0.05, 0.25, 0.5, 0.75, 0.95 }) {
+                out << " " << q << ":" << finals[f].second->Quantile(q);
+            }
+            out << "\n";
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,353 @@
+// File: Evolve.hpp
+// Created on: October 18th, 2026
+
+// A genetic algorithm over the rule parameters (birth and survival
+// thresholds, near and far weights). Each generation's genomes are scored
+// in parallel on headless runs that stop early once they stop being
+// interesting, and scores are cached so a genome is never run twice.
+
+#ifndef EVOLVE_HPP
+#define EVOLVE_HPP
+
+#include "CAEngine.hpp"    // Include the headless automaton
+#include "Termination.hpp" // Include the early-termination criteria
+#include "ThreadPool.hpp"  // Include the thread pool that evaluates genomes in parallel
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief One set of rule parameters.
+ */
+struct Genome {
+    static constexpr int size = 4;
+    std::array<double, size> genes{0.275, 0.8, 0.5, 0.5}; // birth, survival, near weight, far weight
+
+    double Birth() const { return genes[0]; }
+    double Survival() const { return genes[1]; }
+    double NearWeight() const { return genes[2]; }
+    double FarWeight() const { return genes[3]; }
+
+    /**
+     * @brief The genes rounded to a grid of 1e-6, so nearly equal genomes share a cache entry.
+     */
+    std::array<int64_t, size> Key() const {
+        std::array<int64_t, size> key;
+        for (int g = 0; g < size; g++) {
+            key[g] = int64_t(std::llround(genes[g] * 1e6));
+        }
+        return key;
+    }
+};
+
+/**
+ * @brief What one evaluation run did, for objectives to score.
+ */
+struct RunSummary {
+    size_t generations = 0;     // Generations run before stopping
+    size_t maxGenerations = 0;  // Generations the run was allowed
+    TerminationReason reason = TerminationReason::None;
+    double finalLive = 0;       // Live fraction at the end
+    double activeGenerations = 0; // Generations with the live fraction inside the objective's band
+    double bandedChange = 0;    // Sum over those generations of the mean change per cell
+};
+
+/**
+ * @brief Scores a run; higher is better.
+ */
+using Objective = std::function<double(const RunSummary &)>;
+
+/**
+ * @brief Rewards runs that last: the fraction of the allowed generations run.
+ */
+inline double LongevityObjective(const RunSummary & run) {
+    return double(run.generations) / std::max<size_t>(run.maxGenerations, 1);
+}
+
+/**
+ * @brief Rewards long-lived moving structures.
+ *
+ * Counts the average change per cell, per allowed generation, over the
+ * generations in which the population is neither dying out nor filling
+ * the grid. Static patterns, extinction and saturation all score near zero.
+ */
+inline double MovingStructuresObjective(const RunSummary & run) {
+    return run.bandedChange / std::max<size_t>(run.maxGenerations, 1);
+}
+
+/**
+ * @brief Settings of the search and of the runs that score it.
+ */
+struct EvolveSettings {
+    int width = 128;
+    int height = 128;
+    size_t generations = 500;     // Longest evaluation run
+    std::vector<uint64_t> seeds{1, 2, 3}; // Each genome's fitness is its average over these seeds
+    double minLive = 0.001;       // Band of live fractions counted as "structures" by the objectives
+    double maxLive = 0.5;
+
+    int populationSize = 32;
+    int elites = 2;               // Best genomes copied unchanged into the next population
+    int tournamentSize = 3;
+    double crossoverAlpha = 0.3;  // Blend crossover: children range this far beyond their parents
+    double mutationRate = 0.25;   // Chance each gene is mutated
+    double mutationScale = 0.05;  // Standard deviation of a mutation, as a fraction of the gene's range
+    uint64_t randomSeed = 361;
+
+    // Lowest and highest value of each gene
+    std::array<double, Genome::size> low{0.0, 0.0, 0.0, 0.0};
+    std::array<double, Genome::size> high{1.0, 1.0, 1.0, 1.0};
+};
+
+/**
+ * @brief Runs one genome on one seed, stopping early on the default criteria.
+ */
+inline RunSummary EvaluateRun(const Genome & genome, uint64_t seed, const EvolveSettings & settings) {
+    ThreadPool pool(1); // Genomes are evaluated in parallel, each on one thread
+    CAEngine engine(settings.width, settings.height, pool);
+    engine.birth = genome.Birth();
+    engine.survival = genome.Survival();
+    engine.nearWeight = float(genome.NearWeight());
+    engine.farWeight = float(genome.FarWeight());
+    engine.SeedGliders(size_t(settings.width) * settings.height / 100, seed);
+
+    TerminationMonitor monitor(DefaultTerminationCriteria());
+    RunSummary run;
+    run.maxGenerations = settings.generations;
+    GridStats stats;
+    while (run.generations < settings.generations && run.reason == TerminationReason::None) {
+        engine.Step(&stats);
+        run.generations++;
+        const double live = double(stats.alive) / stats.cells;
+        if (live >= settings.minLive && live <= settings.maxLive) {
+            run.activeGenerations++;
+            run.bandedChange += stats.totalChange / stats.cells;
+        }
+        run.finalLive = live;
+        run.reason = monitor.Check(stats, engine.GetGeneration());
+    }
+    return run;
+}
+
+/**
+ * @brief A genetic algorithm over Genomes, with cached, parallel fitness evaluation.
+ *
+ * Each generation keeps the elites, then fills the population with children
+ * of tournament-selected parents: blend crossover followed by Gaussian
+ * mutation, clamped to each gene's range.
+ */
+class GeneticSearch {
+
+    EvolveSettings settings;
+    Objective objective;
+    ThreadPool & pool;
+    std::mt19937_64 random;
+
+    std::map<std::array<int64_t, Genome::size>, double> cache; // Fitness of every genome evaluated so far
+    std::mutex cacheMutex;
+    size_t runs = 0;      // Evaluation runs actually made
+    size_t cacheHits = 0; // Evaluations answered from the cache
+
+    std::vector<Genome> population;
+    std::vector<double> fitness;
+
+    public:
+
+    GeneticSearch(const EvolveSettings & evolveSettings, Objective score, ThreadPool & threads)
+        : settings(evolveSettings), objective(std::move(score)), pool(threads), random(evolveSettings.randomSeed) {
+        // The first population: the page's default rules plus random genomes
+        population.resize(size_t(std::max(settings.populationSize, 2)));
+        for (size_t i = 1; i < population.size(); i++) {
+            for (int g = 0; g < Genome::size; g++) {
+                population[i].genes[g] = std::uniform_real_distribution<double>(settings.low[g], settings.high[g])(random);
+            }
+        }
+    }
+
+    const std::vector<Genome> & Population() const { return population; }
+    const std::vector<double> & Fitness() const { return fitness; }
+    size_t Runs() const { return runs; }
+    size_t CacheHits() const { return cacheHits; }
+
+    /**
+     * @brief Adds previously computed fitness values, e.g. from an earlier session.
+     */
+    void Remember(const Genome & genome, double value) {
+        cache[genome.Key()] = value;
+    }
+
+    /**
+     * @brief A line describing everything besides the genes that a cached fitness depends on.
+     *
+     * @param objectiveName The name of the objective the search was created with.
+     */
+    std::string CacheSetup(const std::string & objectiveName) const {
+        std::ostringstream setup;
+        setup << "objective=" << objectiveName << " width=" << settings.width << " height=" << settings.height
+              << " generations=" << settings.generations << " min_live=" << settings.minLive
+              << " max_live=" << settings.maxLive << " seeds=";
+        for (size_t s = 0; s < settings.seeds.size(); s++) {
+            setup << (s ? "," : "") << settings.seeds[s];
+        }
+        return setup.str();
+    }
+
+    /**
+     * @brief Writes a `# setup` header line, then every cached evaluation as CSV rows: the genes, then the fitness.
+     */
+    void WriteCache(std::ostream & out, const std::string & setup) const {
+        out << "# " << setup << "\n";
+        out.precision(9);
+        for (const auto & entry : cache) {
+            for (int g = 0; g < Genome::size; g++) {
+                out << entry.first[g] * 1e-6 << ",";
+            }
+            out << entry.second << "\n";
+        }
+    }
+
+    /**
+     * @brief Reads a cache written by WriteCache, if it was written for the same setup.
+     *
+     * @return False, reading nothing, if the stream holds a cache whose header
+     * doesn't match `setup` (or has no header); an empty stream is accepted.
+     */
+    bool ReadCache(std::istream & in, const std::string & setup) {
+        std::string header;
+        if (!std::getline(in, header)) {
+            return true;
+        }
+        if (header != "# " + setup) {
+            return false;
+        }
+        Genome genome;
+        double value;
+        char comma;
+        while (in >> genome.genes[0] >> comma >> genome.genes[1] >> comma >> genome.genes[2] >> comma
+                  >> genome.genes[3] >> comma >> value) {
+            Remember(genome, value);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Scores the current population.
+     *
+     * Genomes missing from the cache are evaluated in parallel. Early
+     * termination makes run lengths very uneven, so threads pull genomes
+     * one at a time instead of taking fixed shares.
+     */
+    void Evaluate() {
+        fitness.assign(population.size(), 0);
+        std::vector<size_t> pending;
+        for (size_t i = 0; i < population.size(); i++) {
+            auto hit = cache.find(population[i].Key());
+            if (hit != cache.end()) {
+                fitness[i] = hit->second;
+                cacheHits++;
+            } else {
+                pending.push_back(i);
+            }
+        }
+
+        // The same genome may appear twice in one population; run it once
+        std::vector<size_t> unique;
+        std::map<std::array<int64_t, Genome::size>, size_t> firstOf;
+        for (size_t i : pending) {
+            if (firstOf.emplace(population[i].Key(), i).second) {
+                unique.push_back(i);
+            }
+        }
+
+        std::atomic<size_t> next{0};
+        pool.ParallelFor(0, pool.Size(), [&](int, int) {
+            for (size_t k = next++; k < unique.size(); k = next++) {
+                const Genome & genome = population[unique[k]];
+                double total = 0;
+                for (uint64_t seed : settings.seeds) {
+                    total += objective(EvaluateRun(genome, seed, settings));
+                }
+                std::lock_guard<std::mutex> lock(cacheMutex);
+                cache[genome.Key()] = total / std::max<size_t>(settings.seeds.size(), 1);
+            }
+        });
+        runs += unique.size() * settings.seeds.size();
+        cacheHits += pending.size() - unique.size();
+
+        for (size_t i : pending) {
+            fitness[i] = cache[population[i].Key()];
+        }
+    }
+
+    /**
+     * @brief Index of the fittest genome of the evaluated population.
+     */
+    size_t Best() const {
+        return size_t(std::max_element(fitness.begin(), fitness.end()) - fitness.begin());
+    }
+
+    /**
+     * @brief Replaces the evaluated population with the next generation.
+     */
+    void Breed() {
+        std::vector<size_t> order(population.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [this](size_t a, size_t b) { return fitness[a] > fitness[b]; });
+
+        std::vector<Genome> children;
+        for (int e = 0; e < settings.elites && size_t(e) < order.size(); e++) {
+            children.push_back(population[order[e]]);
+        }
+        while (children.size() < population.size()) {
+            const Genome & mother = population[Tournament()];
+            const Genome & father = population[Tournament()];
+            Genome child;
+            for (int g = 0; g < Genome::size; g++) {
+                // Blend crossover
+                const double lo = std::min(mother.genes[g], father.genes[g]);
+                const double hi = std::max(mother.genes[g], father.genes[g]);
+                const double spread = (hi - lo) * settings.crossoverAlpha;
+                double gene = std::uniform_real_distribution<double>(lo - spread, hi + spread)(random);
+
+                // Gaussian mutation
+                if (std::uniform_real_distribution<double>(0, 1)(random) < settings.mutationRate) {
+                    const double range = settings.high[g] - settings.low[g];
+                    gene += std::normal_distribution<double>(0, settings.mutationScale * range)(random);
+                }
+                child.genes[g] = std::clamp(gene, settings.low[g], settings.high[g]);
+            }
+            children.push_back(child);
+        }
+        population = std::move(children);
+    }
+
+    private:
+
+    size_t Tournament() {
+        std::uniform_int_distribution<size_t> pick(0, population.size() - 1);
+        size_t best = pick(random);
+        for (int t = 1; t < settings.tournamentSize; t++) {
+            const size_t contender = pick(random);
+            if (fitness[contender] > fitness[best]) {
+                best = contender;
+            }
+        }
+        return best;
+    }
+};
+
+#endif
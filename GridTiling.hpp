@@ -0,0 +1,76 @@
+// File: GridTiling.hpp
+// Created on: October 18th, 2026
+
+// Toroidal coordinate wrapping and the tile layout shared by the tiled
+// grids. Every stepper, probe and storage class wraps coordinates through
+// the same Wrap, and the sparse and deduplicated grids cut the grid into
+// the same tiles, so a cell lands in the same tile whichever one holds it.
+
+#ifndef GRID_TILING_HPP
+#define GRID_TILING_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Wraps a coordinate onto 0..n-1, for negative coordinates too.
+ */
+inline int Wrap(int a, int n) {
+    int r = a % n;
+    return r < 0 ? r + n : r;
+}
+
+/**
+ * @brief Splits a width x height grid into tiles of at most maxTile cells a side.
+ *
+ * Tile boundaries split each axis as evenly as possible, so no tile is
+ * narrower than the 3-cell neighborhood radius on any grid of 3+ cells.
+ * Tiles are numbered x-major, like the cells.
+ */
+class TileLayout {
+
+    int w;
+    int h;
+
+    public:
+
+    int tilesW;
+    int tilesH;
+
+    TileLayout(int width, int height, int maxTile)
+        : w(width), h(height),
+          tilesW((width + maxTile - 1) / maxTile), tilesH((height + maxTile - 1) / maxTile) {}
+
+    /**
+     * @brief The first cell of a tile column or row; StartX(tilesW) is the grid width.
+     */
+    int StartX(int tx) const { return int(int64_t(tx) * w / tilesW); }
+    int StartY(int ty) const { return int(int64_t(ty) * h / tilesH); }
+
+    /**
+     * @brief The tile column or row holding an in-range cell coordinate.
+     */
+    int OfX(int x) const {
+        int tx = int(int64_t(x) * tilesW / w);
+        while (StartX(tx + 1) <= x) tx++;
+        while (StartX(tx) > x) tx--;
+        return tx;
+    }
+    int OfY(int y) const {
+        int ty = int(int64_t(y) * tilesH / h);
+        while (StartY(ty + 1) <= y) ty++;
+        while (StartY(ty) > y) ty--;
+        return ty;
+    }
+
+    /**
+     * @brief The index of a tile, wrapping tile coordinates around the grid.
+     */
+    size_t Index(int tx, int ty) const {
+        return size_t(Wrap(tx, tilesW)) * tilesH + Wrap(ty, tilesH);
+    }
+
+    size_t Count() const { return size_t(tilesW) * tilesH; }
+};
+
+#endif
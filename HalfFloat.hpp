@@ -0,0 +1,101 @@
+// File: HalfFloat.hpp
+// Created on: October 18th, 2026
+
+// Conversions between 32-bit floats and IEEE 754 half-precision floats
+// stored as uint16_t. Used by the half-precision grid storage to halve the
+// memory traffic of each generation on grids that don't fit in cache.
+//
+// Both conversions are branch-free: every case is computed with integer and
+// float arithmetic and the right one picked with selects, so the row loops
+// vectorize (with -msimd128 in WASM builds) instead of branching per value.
+
+#ifndef HALF_FLOAT_HPP
+#define HALF_FLOAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Reinterprets the bits of a float as an integer, and back.
+ */
+inline uint32_t FloatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline float BitsFloat(uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Converts one half-precision value to a float.
+ *
+ * Shifting the exponent and mantissa into place and rebiasing the exponent
+ * handles normal numbers. Infinity and NaN get the largest exponent, and a
+ * subnormal half is made normal by a float subtraction.
+ */
+inline float HalfToFloat(uint16_t half) {
+    const uint32_t shiftedExponent = 0x7C00u << 13;
+    uint32_t bits = uint32_t(half & 0x7FFF) << 13;
+    const uint32_t exponent = bits & shiftedExponent;
+    bits += (127 - 15) << 23;
+
+    const uint32_t infNan = bits + ((128 - 16) << 23);
+    const uint32_t subnormal = FloatBits(BitsFloat(bits + (1u << 23)) - BitsFloat(113u << 23));
+    bits = exponent == shiftedExponent ? infNan : bits;
+    bits = exponent == 0 ? subnormal : bits;
+    return BitsFloat(bits | (uint32_t(half & 0x8000) << 16));
+}
+
+/**
+ * @brief Converts a float to half precision, rounding to nearest even.
+ *
+ * Normal results round by adding a bias before truncating the mantissa; the
+ * carry may move into the exponent, which rounds up correctly. Subnormal
+ * results come from adding a magic number that lines the 10 mantissa bits
+ * up with the bottom of the float, letting the float addition round them.
+ */
+inline uint16_t FloatToHalf(float value) {
+    const uint32_t infinity = 255u << 23;
+    const uint32_t halfOverflow = (127u + 16) << 23;             // 65536, the first value too large
+    const uint32_t halfNormal = 113u << 23;                      // 2^-14, the smallest normal half
+    const uint32_t subnormalMagic = ((127u - 15) + (23 - 10) + 1) << 23;
+
+    uint32_t bits = FloatBits(value);
+    const uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    // Infinity stays infinity; NaN keeps a quiet bit set
+    const uint32_t large = bits > infinity ? 0x7E00 : 0x7C00;
+    const uint32_t subnormal = FloatBits(BitsFloat(bits) + BitsFloat(subnormalMagic)) - subnormalMagic;
+    const uint32_t mantissaOdd = (bits >> 13) & 1;
+    const uint32_t normal = (bits + ((15u - 127) << 23) + 0xFFF + mantissaOdd) >> 13;
+
+    uint32_t half = bits < halfNormal ? subnormal : normal;
+    half = bits >= halfOverflow ? large : half;
+    return uint16_t(half | (sign >> 16));
+}
+
+/**
+ * @brief Converts a run of half-precision values to floats.
+ */
+inline void HalfToFloatRow(const uint16_t * in, float * out, size_t count) {
+    for (size_t k = 0; k < count; k++) {
+        out[k] = HalfToFloat(in[k]);
+    }
+}
+
+/**
+ * @brief Converts a run of floats to half precision, rounding to nearest even.
+ */
+inline void FloatToHalfRow(const float * in, uint16_t * out, size_t count) {
+    for (size_t k = 0; k < count; k++) {
+        out[k] = FloatToHalf(in[k]);
+    }
+}
+
+#endif
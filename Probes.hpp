@@ -0,0 +1,245 @@
+// File: Probes.hpp
+// Created on: October 18th, 2026
+
+// Probes record a few small regions of the grid every generation without
+// reading the whole grid again. The stepper hands each column to the probes
+// right after writing it, while it is still in cache, and each probe keeps
+// its recent generations in a fixed-size ring buffer.
+
+#ifndef PROBES_HPP
+#define PROBES_HPP
+
+#include "GridTiling.hpp" // Include the coordinate wrapping shared by every grid
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief What a probe records each generation.
+ */
+enum class ProbeMode {
+    Sum,   // The sum of the region's states: one value per generation
+    Values // Every cell's state, in the order the region lists them
+};
+
+/**
+ * @brief The last `capacity` frames of one probe, oldest first.
+ */
+class ProbeRing {
+
+    size_t frameSize;
+    size_t capacity;
+    std::vector<double> data;        // capacity frames of frameSize values
+    std::vector<size_t> generations; // The generation of each frame
+    size_t next = 0;                 // Slot the next frame goes into
+    size_t count = 0;                // Frames held, up to capacity
+
+    public:
+
+    ProbeRing(size_t valuesPerFrame, size_t frames)
+        : frameSize(valuesPerFrame), capacity(std::max<size_t>(frames, 1)),
+          data(frameSize * capacity), generations(capacity) {}
+
+    size_t Size() const { return count; }
+    size_t Capacity() const { return capacity; }
+    size_t FrameSize() const { return frameSize; }
+
+    /**
+     * @brief The generation of the k-th oldest frame held.
+     */
+    size_t Generation(size_t k) const { return generations[Slot(k)]; }
+
+    /**
+     * @brief The values of the k-th oldest frame held.
+     */
+    const double * Frame(size_t k) const { return data.data() + Slot(k) * frameSize; }
+
+    /**
+     * @brief Appends a frame, overwriting the oldest once the ring is full.
+     */
+    void Push(size_t generation, const double * values) {
+        std::copy(values, values + frameSize, data.begin() + std::ptrdiff_t(next * frameSize));
+        generations[next] = generation;
+        next = (next + 1) % capacity;
+        count = std::min(count + 1, capacity);
+    }
+
+    void Clear() {
+        next = 0;
+        count = 0;
+    }
+
+    private:
+
+    size_t Slot(size_t k) const {
+        return (next + capacity - count + k) % capacity;
+    }
+};
+
+/**
+ * @brief The probes registered on a grid, sampled by its stepper.
+ *
+ * Regions are turned into runs of consecutive cells within one column
+ * (spans) when they are added, so sampling a column only visits the spans
+ * that fall in it. Each span of a Sum probe has its own partial sum, and a
+ * column is only ever sampled by one thread, so a stepper that splits the
+ * grid between threads calls SampleColumn for each column it writes with no
+ * locking or scratch memory; EndGeneration then adds up the partial sums.
+ */
+class ProbeSet {
+
+    struct Span {
+        uint32_t probe;
+        int yBegin;
+        int yEnd;
+        uint32_t slot; // Values mode: position of the cell at yBegin in the probe's frame; Sum mode: its entry in spanSums
+    };
+
+    struct Probe {
+        std::string name;
+        ProbeMode mode;
+        size_t cellCount;
+        std::vector<double> frame; // The generation being sampled
+        ProbeRing ring;
+    };
+
+    int w;
+    int h;
+    std::vector<std::vector<Span>> columns; // The spans in each column
+    std::vector<Probe> probes;
+    std::vector<double> spanSums;      // Sum mode: each span's sum in the generation being sampled
+    std::vector<uint32_t> spanProbes;  // The probe each of those sums belongs to
+
+    public:
+
+    ProbeSet(int width, int height) : w(width), h(height), columns(size_t(width)) {}
+
+    bool Empty() const { return probes.empty(); }
+    size_t Count() const { return probes.size(); }
+    const std::string & Name(size_t probe) const { return probes[probe].name; }
+    ProbeMode Mode(size_t probe) const { return probes[probe].mode; }
+    size_t CellCount(size_t probe) const { return probes[probe].cellCount; }
+    const ProbeRing & Ring(size_t probe) const { return probes[probe].ring; }
+
+    /**
+     * @brief Adds a probe on a rectangle, which may wrap around the grid's edges.
+     *
+     * In Values mode the frame lists the rectangle column by column, like the grid.
+     *
+     * @param x, y The rectangle's first column and row.
+     * @param width, height Its size, clamped to the grid's.
+     * @param capacity The number of generations its ring buffer holds.
+     * @return The probe's index.
+     */
+    size_t AddRect(const std::string & name, int x, int y, int width, int height, ProbeMode mode, size_t capacity) {
+        width = std::clamp(width, 0, w);
+        height = std::clamp(height, 0, h);
+        const size_t probe = probes.size();
+        uint32_t slot = 0;
+        const int top = Wrap(y, h);
+        for (int dx = 0; dx < width; dx++) {
+            const size_t x1 = size_t(Wrap(x + dx, w));
+            // A rectangle crossing the bottom edge continues at the top of the column
+            const int firstRun = std::min(height, h - top);
+            AddSpan(x1, probe, mode, top, top + firstRun, slot);
+            if (firstRun < height) {
+                AddSpan(x1, probe, mode, 0, height - firstRun, slot + uint32_t(firstRun));
+            }
+            slot += uint32_t(height);
+        }
+        probes.push_back(MakeProbe(name, mode, size_t(width) * height, capacity));
+        return probe;
+    }
+
+    /**
+     * @brief Adds a probe on a set of cells; coordinates wrap around the grid.
+     *
+     * In Values mode the frame lists the points in the order given.
+     *
+     * @return The probe's index.
+     */
+    size_t AddPoints(const std::string & name, const std::vector<std::pair<int, int>> & points, ProbeMode mode, size_t capacity) {
+        const size_t probe = probes.size();
+        for (size_t p = 0; p < points.size(); p++) {
+            const int y = Wrap(points[p].second, h);
+            AddSpan(size_t(Wrap(points[p].first, w)), probe, mode, y, y + 1, uint32_t(p));
+        }
+        probes.push_back(MakeProbe(name, mode, points.size(), capacity));
+        return probe;
+    }
+
+    /**
+     * @brief Clears every probe's ring buffer, e.g. when a new run starts.
+     */
+    void ClearRings() {
+        for (Probe & probe : probes) {
+            probe.ring.Clear();
+        }
+    }
+
+    /**
+     * @brief Samples the newly written states of one column.
+     *
+     * Values are written straight into the probes' frames, each cell to its
+     * own slot, and sums into the spans' own partial sums, so threads
+     * sampling different columns never collide.
+     */
+    void SampleColumn(int x, const float * column) {
+        for (const Span & span : columns[size_t(x)]) {
+            Probe & probe = probes[span.probe];
+            if (probe.mode == ProbeMode::Sum) {
+                double sum = 0;
+                for (int y = span.yBegin; y < span.yEnd; y++) {
+                    sum += column[y];
+                }
+                spanSums[span.slot] = sum;
+            } else {
+                std::copy(column + span.yBegin, column + span.yEnd, probe.frame.begin() + span.slot);
+            }
+        }
+    }
+
+    /**
+     * @brief Adds up the sums and appends the sampled generation to every probe's ring buffer.
+     *
+     * Every column holding a span must have been sampled since the last call.
+     */
+    void EndGeneration(size_t generation) {
+        for (Probe & probe : probes) {
+            if (probe.mode == ProbeMode::Sum) {
+                probe.frame[0] = 0;
+            }
+        }
+        for (size_t s = 0; s < spanSums.size(); s++) {
+            probes[spanProbes[s]].frame[0] += spanSums[s];
+        }
+        for (Probe & probe : probes) {
+            probe.ring.Push(generation, probe.frame.data());
+        }
+    }
+
+    private:
+
+    /**
+     * @brief Adds the span [yBegin, yEnd) of column x to a probe, giving it a partial sum in Sum mode.
+     */
+    void AddSpan(size_t x, size_t probe, ProbeMode mode, int yBegin, int yEnd, uint32_t slot) {
+        if (mode == ProbeMode::Sum) {
+            slot = uint32_t(spanSums.size());
+            spanSums.push_back(0);
+            spanProbes.push_back(uint32_t(probe));
+        }
+        columns[x].push_back(Span{uint32_t(probe), yBegin, yEnd, slot});
+    }
+
+    static Probe MakeProbe(const std::string & name, ProbeMode mode, size_t cellCount, size_t capacity) {
+        const size_t frameSize = mode == ProbeMode::Sum ? 1 : cellCount;
+        return Probe{name, mode, cellCount, std::vector<double>(frameSize, 0), ProbeRing(frameSize, capacity)};
+    }
+};
+
+#endif
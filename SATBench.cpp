@@ -0,0 +1,79 @@
+// File: SATBench.cpp
+// Created on: October 18th, 2026
+
+// Native benchmark of the summed-area table builder. For each grid size
+// it fills a random grid, checks the table's box sums against sums added
+// up cell by cell, then times the build with 1, 2, 4, ... threads.
+//
+// Build: g++ -std=c++17 -O3 -march=native -pthread SATBench.cpp -o SATBench
+// Usage: ./SATBench [largest grid side] [most threads]
+
+#include "SummedArea.hpp" // Include the summed-area table under test
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/**
+ * @brief The largest difference between the table's box sums and sums added up cell by cell.
+ *
+ * Checks every cell with radii 1 and 3 on small grids, and a fixed sample of cells on large ones.
+ */
+double MaxBoxSumError(const SummedAreaTable & sat, const std::vector<float> & cells, int w, int h) {
+    double maxError = 0;
+    const int stride = std::max(1, (w * h) / 200000);
+    for (int c = 0; c < w * h; c += stride) {
+        const int x = c / h;
+        const int y = c % h;
+        for (int radius : {1, 3}) {
+            double sum = 0;
+            for (int i = x - radius; i <= x + radius; i++) {
+                for (int j = y - radius; j <= y + radius; j++) {
+                    sum += cells[size_t((i % w + w) % w) * h + (j % h + h) % h];
+                }
+            }
+            maxError = std::max(maxError, std::abs(sat.BoxSum(x, y, radius) - sum));
+        }
+    }
+    return maxError;
+}
+
+int main(int argc, char * argv[]) {
+    const int largest = argc > 1 ? std::atoi(argv[1]) : 4096;
+    const int maxThreads = argc > 2 ? std::atoi(argv[2]) : 8;
+
+    std::mt19937 random(361);
+    std::uniform_real_distribution<float> state(0.0f, 1.0f);
+
+    std::printf("side,threads,build_ms,cells_per_ns,max_error\n");
+    for (int side = 256; side <= largest; side *= 2) {
+        std::vector<float> cells(size_t(side) * side);
+        for (float & cell : cells) {
+            cell = state(random);
+        }
+
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+            ThreadPool pool(threads);
+            SummedAreaTable sat(side, side, 3);
+
+            // Warm up and check the result before timing
+            sat.Build(cells.data(), pool);
+            const double error = MaxBoxSumError(sat, cells, side, side);
+
+            const int repeats = std::max(3, int((1 << 26) / cells.size()));
+            const auto start = std::chrono::steady_clock::now();
+            for (int r = 0; r < repeats; r++) {
+                sat.Build(cells.data(), pool);
+            }
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            const double ms = elapsed.count() / repeats;
+
+            std::printf("%d,%d,%.3f,%.3f,%.3g\n", side, threads, ms, cells.size() / (ms * 1e6), error);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,346 @@
+// File: SparseGrid.hpp
+// Created on: October 18th, 2026
+
+// Tiled sparse storage for the 2D automaton. Tiles with no live cells
+// take no memory, tiles with few live cells keep only a bitmask and their
+// packed nonzero values, and busy tiles switch to plain dense storage.
+
+#ifndef SPARSE_GRID_HPP
+#define SPARSE_GRID_HPP
+
+#include "ThreadPool.hpp" // Include the thread pool that parallelizes each generation
+#include "CARules.hpp"    // Include the neighborhood average shared by every stepper
+#include "GridTiling.hpp" // Include the tile layout shared with the other tiled grid
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A toroidal 2D grid stored as sparse or dense tiles.
+ *
+ * The grid is split into tiles of at most 32x32 cells, as close to equal in
+ * size as possible. Each tile is empty, sparse (one 32-bit live mask per
+ * column plus the nonzero values packed in column order) or dense (every
+ * value). A generation copies the nonzero cells around each output tile
+ * into a padded block, then gathers each cell's neighborhood sums with the
+ * shared NeighborhoodAvg, so results match the plain stepper exactly. When
+ * an empty neighborhood stays empty (birth above 0, no noise), tiles with no
+ * live tile around them and cells with nothing alive within reach are
+ * skipped, so the work follows the live cells, not the grid area.
+ */
+class SparseGrid {
+
+    static constexpr int maxTile = 32;
+
+    struct Tile {
+        enum class Kind { Empty, Sparse, Dense };
+        Kind kind = Kind::Empty;
+        uint32_t mask[maxTile] = {};  // Sparse: bit y of mask[x] is set if that cell is nonzero
+        uint16_t offset[maxTile] = {}; // Sparse: index in `values` of column x's first nonzero
+        std::vector<float> values;     // Sparse: packed nonzeros; Dense: x-major tile values
+    };
+
+    int w;
+    int h;
+    TileLayout layout;
+    double denseFraction = 0.25; // Tiles with more live cells than this are stored dense
+
+    std::vector<Tile> tiles;
+    std::vector<Tile> nextTiles;
+
+    ThreadPool & pool;
+
+    public:
+
+    /**
+     * @brief Creates an empty grid.
+     *
+     * @param width Number of cells along x.
+     * @param height Number of cells along y.
+     * @param threads The pool used to parallelize each generation.
+     */
+    SparseGrid(int width, int height, ThreadPool & threads)
+        : w(width), h(height), layout(width, height, maxTile), pool(threads) {
+        tiles.resize(layout.Count());
+        nextTiles.resize(tiles.size());
+    }
+
+    /**
+     * @brief Replaces the contents with a dense grid laid out like CAAnimator's cells.
+     *
+     * @param cells The grid, indexed x * height + y.
+     */
+    void LoadDense(const std::vector<float> & cells) {
+        pool.ParallelFor(0, layout.tilesW, [&](int begin, int end) {
+            std::vector<float> block(maxTile * maxTile);
+            for (int tx = begin; tx < end; tx++) {
+                for (int ty = 0; ty < layout.tilesH; ty++) {
+                    const int x0 = layout.StartX(tx);
+                    const int y0 = layout.StartY(ty);
+                    const int tw = layout.StartX(tx + 1) - x0;
+                    const int th = layout.StartY(ty + 1) - y0;
+                    for (int x = 0; x < tw; x++) {
+                        for (int y = 0; y < th; y++) {
+                            block[x * maxTile + y] = cells[size_t(x0 + x) * h + y0 + y];
+                        }
+                    }
+                    Pack(tiles[layout.Index(tx, ty)], block.data(), tw, th);
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Writes the contents out as a dense grid laid out like CAAnimator's cells.
+     *
+     * @param cells The destination, indexed x * height + y; must hold every cell.
+     */
+    void StoreDense(std::vector<float> & cells) const {
+        pool.ParallelFor(0, layout.tilesW, [&](int begin, int end) {
+            for (int tx = begin; tx < end; tx++) {
+                for (int ty = 0; ty < layout.tilesH; ty++) {
+                    const int x0 = layout.StartX(tx);
+                    const int y0 = layout.StartY(ty);
+                    const int tw = layout.StartX(tx + 1) - x0;
+                    const int th = layout.StartY(ty + 1) - y0;
+                    for (int x = 0; x < tw; x++) {
+                        float * column = cells.data() + size_t(x0 + x) * h + y0;
+                        std::fill(column, column + th, 0.0f);
+                    }
+                    ForEachNonzero(tiles[layout.Index(tx, ty)], tw, th, [&](int x, int y, float value) {
+                        cells[size_t(x0 + x) * h + y0 + y] = value;
+                    });
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Reads one cell, wrapping around the grid.
+     */
+    float Get(int x, int y) const {
+        x = Wrap(x, w);
+        y = Wrap(y, h);
+        const int tx = layout.OfX(x);
+        const int ty = layout.OfY(y);
+        const Tile & tile = tiles[layout.Index(tx, ty)];
+        const int lx = x - layout.StartX(tx);
+        const int ly = y - layout.StartY(ty);
+
+        if (tile.kind == Tile::Kind::Dense) {
+            return tile.values[lx * maxTile + ly];
+        }
+        if (tile.kind == Tile::Kind::Sparse && (tile.mask[lx] >> ly & 1)) {
+            return tile.values[tile.offset[lx] + Popcount(tile.mask[lx] & ((1u << ly) - 1))];
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Writes one cell, wrapping around the grid; the cell's tile is repacked.
+     */
+    void Set(int x, int y, float value) {
+        x = Wrap(x, w);
+        y = Wrap(y, h);
+        const int tx = layout.OfX(x);
+        const int ty = layout.OfY(y);
+        const int tw = layout.StartX(tx + 1) - layout.StartX(tx);
+        const int th = layout.StartY(ty + 1) - layout.StartY(ty);
+        Tile & tile = tiles[layout.Index(tx, ty)];
+
+        float block[maxTile * maxTile] = {};
+        ForEachNonzero(tile, tw, th, [&](int lx, int ly, float v) { block[lx * maxTile + ly] = v; });
+        block[(x - layout.StartX(tx)) * maxTile + (y - layout.StartY(ty))] = value;
+        Pack(tile, block, tw, th);
+    }
+
+    /**
+     * @brief Counts the tiles stored in each form.
+     *
+     * @return The number of empty, sparse and dense tiles, in that order.
+     */
+    std::vector<size_t> TileCounts() const {
+        std::vector<size_t> counts(3, 0);
+        for (const Tile & tile : tiles) {
+            counts[int(tile.kind)]++;
+        }
+        return counts;
+    }
+
+    /**
+     * @brief Computes the next generation.
+     *
+     * @param rule Called as rule(self, nearAvg, distAvg, x, y) for every cell
+     *        that is computed; returns its next state.
+     * @param emptyStaysEmpty Whether a dead cell with no live neighbors stays
+     *        dead under `rule`. If so, only cells with something alive within
+     *        reach are computed; otherwise every cell is.
+     */
+    template <typename RULE>
+    void Step(RULE && rule, bool emptyStaysEmpty) {
+        pool.ParallelFor(0, layout.tilesW, [&](int begin, int end) {
+            for (int tx = begin; tx < end; tx++) {
+                for (int ty = 0; ty < layout.tilesH; ty++) {
+                    StepTile(tx, ty, rule, emptyStaysEmpty);
+                }
+            }
+        });
+        std::swap(tiles, nextTiles);
+    }
+
+    private:
+
+    static int Popcount(uint32_t bits) {
+        return __builtin_popcount(bits);
+    }
+
+    /**
+     * @brief Calls fn(x, y, value) for every nonzero cell of a tile, in tile coordinates.
+     */
+    template <typename FUN>
+    static void ForEachNonzero(const Tile & tile, int tw, int th, FUN && fn) {
+        if (tile.kind == Tile::Kind::Dense) {
+            for (int x = 0; x < tw; x++) {
+                for (int y = 0; y < th; y++) {
+                    float value = tile.values[x * maxTile + y];
+                    if (value != 0) {
+                        fn(x, y, value);
+                    }
+                }
+            }
+        } else if (tile.kind == Tile::Kind::Sparse) {
+            for (int x = 0; x < tw; x++) {
+                uint32_t bits = tile.mask[x];
+                size_t k = tile.offset[x];
+                while (bits) {
+                    int y = __builtin_ctz(bits);
+                    fn(x, y, tile.values[k++]);
+                    bits &= bits - 1;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Stores a dense block of tile values in the most compact form.
+     *
+     * @param tile The tile to fill.
+     * @param block The values, indexed x * maxTile + y.
+     * @param tw The tile's width.
+     * @param th The tile's height.
+     */
+    void Pack(Tile & tile, const float * block, int tw, int th) const {
+        int live = 0;
+        for (int x = 0; x < tw; x++) {
+            for (int y = 0; y < th; y++) {
+                live += block[x * maxTile + y] != 0;
+            }
+        }
+
+        if (live == 0) {
+            tile.kind = Tile::Kind::Empty;
+            tile.values.clear();
+        } else if (live > denseFraction * tw * th) {
+            tile.kind = Tile::Kind::Dense;
+            tile.values.assign(block, block + maxTile * maxTile);
+        } else {
+            tile.kind = Tile::Kind::Sparse;
+            tile.values.clear();
+            for (int x = 0; x < tw; x++) {
+                tile.mask[x] = 0;
+                tile.offset[x] = uint16_t(tile.values.size());
+                for (int y = 0; y < th; y++) {
+                    float value = block[x * maxTile + y];
+                    if (value != 0) {
+                        tile.mask[x] |= 1u << y;
+                        tile.values.push_back(value);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Computes one output tile from a padded copy of the cells around it.
+     *
+     * Each nonzero cell of the neighboring tiles is copied to every position
+     * of the padded block that wraps onto it, so grids narrower than the
+     * 7-cell neighborhood see the same periodic images as the plain
+     * stepper's wrapping NeighborsAvg. A bitmask of the nonzero rows in each
+     * padded column finds the cells with nothing alive within reach.
+     */
+    template <typename RULE>
+    void StepTile(int tx, int ty, RULE & rule, bool emptyStaysEmpty) {
+        const int x0 = layout.StartX(tx);
+        const int y0 = layout.StartY(ty);
+        const int tw = layout.StartX(tx + 1) - x0;
+        const int th = layout.StartY(ty + 1) - y0;
+        Tile & out = nextTiles[layout.Index(tx, ty)];
+
+        // Distinct neighboring tiles (fewer than 9 on grids only a tile or two across)
+        size_t sources[9];
+        int sourceCount = 0;
+        for (int a = -1; a <= 1; a++) {
+            for (int b = -1; b <= 1; b++) {
+                size_t index = layout.Index(tx + a, ty + b);
+                if (std::find(sources, sources + sourceCount, index) == sources + sourceCount
+                    && tiles[index].kind != Tile::Kind::Empty) {
+                    sources[sourceCount++] = index;
+                }
+            }
+        }
+        if (sourceCount == 0 && emptyStaysEmpty) {
+            out.kind = Tile::Kind::Empty;
+            out.values.clear();
+            return;
+        }
+
+        // The tile with a 3-cell border on every side, and the nonzero rows of each padded column
+        constexpr int maxPadded = maxTile + 6;
+        const int pw = tw + 6;
+        const int ph = th + 6;
+        float padded[maxPadded * maxPadded] = {};
+        uint64_t rows[maxPadded] = {};
+
+        for (int s = 0; s < sourceCount; s++) {
+            const int sx = int(sources[s] / layout.tilesH);
+            const int sy = int(sources[s] % layout.tilesH);
+            const int sx0 = layout.StartX(sx);
+            const int sy0 = layout.StartY(sy);
+            ForEachNonzero(tiles[sources[s]], layout.StartX(sx + 1) - sx0, layout.StartY(sy + 1) - sy0,
+                           [&](int lx, int ly, float value) {
+                const int pyFirst = Wrap(sy0 + ly - (y0 - 3), h);
+                for (int px = Wrap(sx0 + lx - (x0 - 3), w); px < pw; px += w) {
+                    for (int py = pyFirst; py < ph; py += h) {
+                        padded[px * maxPadded + py] = value;
+                        rows[px] |= uint64_t(1) << py;
+                    }
+                }
+            });
+        }
+
+        const auto paddedCell = [&padded](int i, int j) { return padded[i * maxPadded + j]; };
+        float block[maxTile * maxTile] = {};
+        for (int x = 0; x < tw; x++) {
+            // Nonzero rows anywhere in the 7 columns around this one
+            uint64_t reach = 0;
+            for (int px = x; px < x + 7; px++) {
+                reach |= rows[px];
+            }
+            const float * column = padded + (x + 3) * maxPadded;
+            for (int y = 0; y < th; y++) {
+                if (emptyStaysEmpty && !(reach >> y & 0x7F)) {
+                    continue; // Nothing alive within reach: the cell stays dead
+                }
+                const float nearAvg = NeighborhoodAvg(x + 3, y + 3, 1, paddedCell);
+                const float distAvg = NeighborhoodAvg(x + 3, y + 3, 3, paddedCell);
+                block[x * maxTile + y] = rule(column[y + 3], nearAvg, distAvg, x0 + x, y0 + y);
+            }
+        }
+        Pack(out, block, tw, th);
+    }
+};
+
+#endif
@@ -0,0 +1,374 @@
+// File: Spectrum.hpp
+// Created on: October 18th, 2026
+
+// Spatial analysis of the grid's pattern scale: the 2D power spectrum and
+// the spatial autocorrelation, both averaged over rings of equal radius.
+// SpectralAnalyzer runs the analysis on a background thread, working on a
+// copy of the grid, so the simulation never waits for it.
+
+#ifndef SPECTRUM_HPP
+#define SPECTRUM_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A one-dimensional discrete Fourier transform of any length.
+ *
+ * Powers of two use an iterative radix-2 FFT; other lengths use Bluestein's
+ * algorithm, which rewrites the transform as a convolution computed with
+ * power-of-two FFTs, so every length costs O(n log n).
+ */
+class FFT {
+
+    using Complex = std::complex<double>;
+
+    size_t n;
+    size_t m;                   // Power-of-two length of the Bluestein convolution (n itself for powers of two)
+    std::vector<Complex> twiddles; // exp(-2 pi i k / m) for k < m / 2
+    std::vector<Complex> chirp;    // Bluestein only: exp(-pi i k^2 / n)
+    std::vector<Complex> kernel;   // Bluestein only: the transformed conjugate chirp
+    std::vector<Complex> work;     // Scratch for Bluestein and for strided sequences
+
+    public:
+
+    explicit FFT(size_t length) : n(length), m(1) {
+        while (m < n) {
+            m <<= 1;
+        }
+        if (m != n) {
+            m = 1;
+            while (m < 2 * n - 1) {
+                m <<= 1;
+            }
+        }
+        twiddles.resize(m / 2);
+        for (size_t k = 0; k < m / 2; k++) {
+            twiddles[k] = std::polar(1.0, -2 * M_PI * double(k) / double(m));
+        }
+
+        if (m != n) {
+            chirp.resize(n);
+            for (size_t k = 0; k < n; k++) {
+                // k^2 mod 2n keeps the angle small enough to stay accurate
+                const double angle = M_PI * double((k * k) % (2 * n)) / double(n);
+                chirp[k] = std::polar(1.0, -angle);
+            }
+            kernel.assign(m, 0);
+            kernel[0] = std::conj(chirp[0]);
+            for (size_t k = 1; k < n; k++) {
+                kernel[k] = kernel[m - k] = std::conj(chirp[k]);
+            }
+            Radix2(kernel.data(), false);
+            work.resize(m);
+        }
+    }
+
+    size_t Size() const { return n; }
+
+    /**
+     * @brief Transforms one sequence of length Size(), in place.
+     *
+     * @param data The first element of the sequence.
+     * @param stride Distance between consecutive elements of a sequence.
+     * @param inverse Computes the unnormalized inverse transform instead.
+     */
+    void Transform(Complex * data, size_t stride, bool inverse) {
+        if (m == n) {
+            if (stride == 1) {
+                Radix2(data, inverse);
+            } else {
+                work.resize(n);
+                for (size_t k = 0; k < n; k++) {
+                    work[k] = data[k * stride];
+                }
+                Radix2(work.data(), inverse);
+                for (size_t k = 0; k < n; k++) {
+                    data[k * stride] = work[k];
+                }
+            }
+            return;
+        }
+
+        // Bluestein: X_k = conj(c_k) * sum_j (x_j c_j) conj(c_{k-j}), with c_j = exp(-pi i j^2 / n)
+        // (the inverse transform conjugates the input and output)
+        std::fill(work.begin(), work.end(), Complex(0));
+        for (size_t k = 0; k < n; k++) {
+            const Complex x = inverse ? std::conj(data[k * stride]) : data[k * stride];
+            work[k] = x * chirp[k];
+        }
+        Radix2(work.data(), false);
+        for (size_t k = 0; k < m; k++) {
+            work[k] *= kernel[k];
+        }
+        Radix2(work.data(), true);
+        for (size_t k = 0; k < n; k++) {
+            const Complex x = work[k] * chirp[k] / double(m);
+            data[k * stride] = inverse ? std::conj(x) : x;
+        }
+    }
+
+    private:
+
+    /**
+     * @brief Unnormalized radix-2 FFT of length m, in place.
+     */
+    void Radix2(Complex * a, bool inverse) const {
+        for (size_t i = 1, j = 0; i < m; i++) {
+            size_t bit = m >> 1;
+            for (; j & bit; bit >>= 1) {
+                j ^= bit;
+            }
+            j ^= bit;
+            if (i < j) {
+                std::swap(a[i], a[j]);
+            }
+        }
+        for (size_t len = 2; len <= m; len <<= 1) {
+            const size_t step = m / len;
+            for (size_t i = 0; i < m; i += len) {
+                for (size_t k = 0; k < len / 2; k++) {
+                    const Complex w = inverse ? std::conj(twiddles[k * step]) : twiddles[k * step];
+                    const Complex t = a[i + k + len / 2] * w;
+                    a[i + k + len / 2] = a[i + k] - t;
+                    a[i + k] += t;
+                }
+            }
+        }
+    }
+};
+
+/**
+ * @brief The results of analyzing one snapshot of the grid.
+ */
+struct SpectrumResult {
+    size_t generation = 0;
+    std::vector<double> radialPower;       // Power spectrum averaged over rings of wavenumber k (k periods per shorter side)
+    std::vector<double> radialCorrelation; // Autocorrelation averaged over rings of integer distance; 1 at 0
+    double correlationLength = 0;          // Distance at which the correlation first drops below 1/e
+    double dominantWavelength = 0;         // Cells per period of the strongest nonzero wavenumber
+};
+
+/**
+ * @brief Computes the radial power spectrum and autocorrelation of a toroidal grid.
+ *
+ * The grid's mean is removed first, so the spectrum describes the pattern
+ * rather than the overall density. The autocorrelation is the inverse
+ * transform of the power spectrum (Wiener-Khinchin), which on a torus is
+ * exactly the circular autocorrelation.
+ */
+class SpectrumAnalysis {
+
+    using Complex = std::complex<double>;
+
+    int w;
+    int h;
+    FFT fftX;
+    FFT fftY;
+    std::vector<Complex> field; // x-major like the grid: field[x * h + y]
+
+    public:
+
+    SpectrumAnalysis(int width, int height) : w(width), h(height), fftX(size_t(width)), fftY(size_t(height)) {
+        field.resize(size_t(w) * h);
+    }
+
+    /**
+     * @brief Analyzes a grid laid out like CAAnimator's cells (indexed x * height + y).
+     */
+    SpectrumResult Analyze(const float * cells, size_t generation) {
+        const size_t count = size_t(w) * h;
+        double mean = 0;
+        for (size_t c = 0; c < count; c++) {
+            mean += cells[c];
+        }
+        mean /= double(count);
+        for (size_t c = 0; c < count; c++) {
+            field[c] = cells[c] - mean;
+        }
+
+        Transform2D(false);
+        for (Complex & value : field) {
+            value = std::norm(value) / double(count);
+        }
+
+        SpectrumResult result;
+        result.generation = generation;
+        result.radialPower = RadialAverage(true);
+
+        // The power spectrum transforms back into the autocorrelation
+        Transform2D(true);
+        const double variance = field[0].real() / double(count);
+        for (Complex & value : field) {
+            value = variance > 0 ? value.real() / double(count) / variance : 0.0;
+        }
+        result.radialCorrelation = RadialAverage(false);
+
+        const double threshold = std::exp(-1.0);
+        for (size_t r = 1; r < result.radialCorrelation.size(); r++) {
+            if (result.radialCorrelation[r] < threshold) {
+                // Interpolate between the rings on either side of the crossing
+                const double before = result.radialCorrelation[r - 1];
+                const double after = result.radialCorrelation[r];
+                result.correlationLength = double(r - 1) + (before - threshold) / (before - after);
+                break;
+            }
+        }
+
+        size_t peak = 0;
+        for (size_t k = 1; k < result.radialPower.size(); k++) {
+            if (peak == 0 || result.radialPower[k] > result.radialPower[peak]) {
+                peak = k;
+            }
+        }
+        result.dominantWavelength = peak > 0 ? double(std::min(w, h)) / double(peak) : 0;
+        return result;
+    }
+
+    private:
+
+    void Transform2D(bool inverse) {
+        // Along y: each column is contiguous
+        for (int x = 0; x < w; x++) {
+            fftY.Transform(field.data() + size_t(x) * h, 1, inverse);
+        }
+        // Along x: elements of a row are a column apart
+        for (int y = 0; y < h; y++) {
+            fftX.Transform(field.data() + y, size_t(h), inverse);
+        }
+    }
+
+    /**
+     * @brief Averages the real part of `field` over rings of equal integer radius.
+     *
+     * Offsets wrap around, so index k stands for min(k, size - k). Rings run
+     * out to half the shorter side, beyond which they no longer fit.
+     *
+     * @param frequency Whether `field` is a spectrum. Its indices then count
+     * periods across each side, which are rescaled to periods across the
+     * shorter side so that rings are round on rectangular grids too.
+     */
+    std::vector<double> RadialAverage(bool frequency) const {
+        const int shorter = std::min(w, h);
+        const double scaleX = frequency ? double(shorter) / w : 1.0;
+        const double scaleY = frequency ? double(shorter) / h : 1.0;
+        const size_t rings = size_t(shorter / 2) + 1;
+        std::vector<double> sum(rings, 0);
+        std::vector<size_t> count(rings, 0);
+        for (int x = 0; x < w; x++) {
+            const double dx = std::min(x, w - x) * scaleX;
+            for (int y = 0; y < h; y++) {
+                const double dy = std::min(y, h - y) * scaleY;
+                const size_t r = size_t(std::lround(std::sqrt(dx * dx + dy * dy)));
+                if (r < rings) {
+                    sum[r] += field[size_t(x) * h + y].real();
+                    count[r]++;
+                }
+            }
+        }
+        for (size_t r = 0; r < rings; r++) {
+            sum[r] = count[r] ? sum[r] / double(count[r]) : 0;
+        }
+        return sum;
+    }
+};
+
+/**
+ * @brief Runs SpectrumAnalysis on a background thread.
+ *
+ * The stepping thread offers snapshots; an offer made while the previous one
+ * is still being analyzed is declined rather than waited for, so stepping
+ * never blocks on the analysis. The newest result can be read at any time.
+ */
+class SpectralAnalyzer {
+
+    SpectrumAnalysis analysis;
+    std::vector<float> snapshot;
+    size_t snapshotGeneration = 0;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool busy = false;     // A snapshot is waiting or being analyzed
+    bool quit = false;
+    SpectrumResult latest;
+    size_t published = 0;  // Results published so far
+
+    std::thread worker;
+
+    public:
+
+    SpectralAnalyzer(int width, int height) : analysis(width, height), snapshot(size_t(width) * height) {
+        worker = std::thread([this]() { Loop(); });
+    }
+
+    ~SpectralAnalyzer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    /**
+     * @brief Hands a copy of the grid to the analysis thread, unless it is still busy.
+     *
+     * @return True if the snapshot was taken.
+     */
+    bool Offer(const float * cells, size_t generation) {
+        {
+            std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+            if (!lock.owns_lock() || busy) {
+                return false;
+            }
+            std::copy(cells, cells + snapshot.size(), snapshot.begin());
+            snapshotGeneration = generation;
+            busy = true;
+        }
+        wake.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Copies the newest result, if there is one newer than `seen` results.
+     *
+     * @param out Receives the result.
+     * @param seen The number of results the caller has already read; updated.
+     */
+    bool Latest(SpectrumResult & out, size_t & seen) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (published == seen) {
+            return false;
+        }
+        out = latest;
+        seen = published;
+        return true;
+    }
+
+    private:
+
+    void Loop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this]() { return quit || busy; });
+            if (quit) {
+                return;
+            }
+            // The snapshot is only written while not busy, so it can be read unlocked
+            lock.unlock();
+            SpectrumResult result = analysis.Analyze(snapshot.data(), snapshotGeneration);
+            lock.lock();
+            latest = std::move(result);
+            published++;
+            busy = false;
+        }
+    }
+};
+
+#endif
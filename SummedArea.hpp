@@ -0,0 +1,129 @@
+// File: SummedArea.hpp
+// Created on: October 18th, 2026
+
+// A summed-area table over the toroidal grid, rebuilt every generation so
+// any square neighborhood sum costs four lookups. The table covers the grid
+// plus a wrapped border, so neighborhoods never need wrap-around logic.
+
+#ifndef SUMMED_AREA_HPP
+#define SUMMED_AREA_HPP
+
+#include "ThreadPool.hpp" // Include the thread pool that parallelizes the build
+#include "GridTiling.hpp" // Include the coordinate wrapping shared by every grid
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * @brief A 2D inclusive prefix sum of a toroidal grid with a wrapped border.
+ *
+ * Entries are doubles. In float, a large grid's running totals grow so big
+ * that subtracting two of them to get a small neighborhood sum cancels away
+ * most of the significant bits, and compensated summation can't fix that
+ * because the error lies in the stored totals themselves.
+ *
+ * The build takes two passes over the table. The first scans along y inside
+ * each column; columns are independent, so they are split between threads.
+ * The second adds each column into the next; that loop runs over contiguous
+ * memory, so it vectorizes, and it is split between threads in blocks of
+ * rows that stay in cache while the pass walks across the columns.
+ */
+class SummedAreaTable {
+
+    int w;      // Grid width
+    int h;      // Grid height
+    int border; // Wrapped cells added on every side; the largest radius BoxSum supports
+    int tableH; // Entries per table column: padded height plus the leading zero
+
+    std::vector<double> table; // (w + 2 * border + 1) columns of tableH entries
+
+    public:
+
+    /**
+     * @brief Allocates the table for a grid.
+     *
+     * @param width Grid width.
+     * @param height Grid height.
+     * @param maxRadius The largest neighborhood radius that will be queried.
+     */
+    SummedAreaTable(int width, int height, int maxRadius)
+        : w(width), h(height), border(maxRadius), tableH(height + 2 * maxRadius + 1) {
+        table.assign(size_t(w + 2 * border + 1) * tableH, 0.0);
+    }
+
+    /**
+     * @brief Rebuilds the table from a grid laid out like CAAnimator's cells.
+     *
+     * @param cells The grid, indexed x * height + y.
+     * @param pool The threads to split both passes between.
+     */
+    void Build(const float * cells, ThreadPool & pool) {
+        const int paddedW = w + 2 * border;
+
+        // Pass 1: prefix sums down each padded column (table column 0 stays zero)
+        pool.ParallelFor(0, paddedW, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                const float * column = cells + size_t(Wrap(i - border, w)) * h;
+                double * out = table.data() + size_t(i + 1) * tableH;
+                double sum = 0;
+                out[0] = 0;
+                int k = 1;
+                for (int j = h - border; j < h; j++) {
+                    sum += column[Wrap(j, h)];
+                    out[k++] = sum;
+                }
+                for (int j = 0; j < h; j++) {
+                    sum += column[j];
+                    out[k++] = sum;
+                }
+                for (int j = 0; j < border; j++) {
+                    sum += column[Wrap(j, h)];
+                    out[k++] = sum;
+                }
+            }
+        });
+
+        // Pass 2: accumulate across columns, one cache-sized block of rows per
+        // task, with blocks small enough that every thread gets one
+        const int blockRows = std::max(1, std::min(512, (tableH + pool.Size() - 1) / pool.Size()));
+        const int blocks = (tableH + blockRows - 1) / blockRows;
+        pool.ParallelFor(0, blocks, [&](int begin, int end) {
+            for (int b = begin; b < end; b++) {
+                const int first = b * blockRows;
+                const int last = std::min(first + blockRows, tableH);
+                for (int i = 2; i <= paddedW; i++) {
+                    const double * previous = table.data() + size_t(i - 1) * tableH;
+                    double * current = table.data() + size_t(i) * tableH;
+                    for (int j = first; j < last; j++) {
+                        current[j] += previous[j];
+                    }
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Sums the (2 * radius + 1)^2 square centered on a cell, wrapping around.
+     *
+     * @param x The x-coordinate of the center, in [0, width).
+     * @param y The y-coordinate of the center, in [0, height).
+     * @param radius The square's radius; at most the maxRadius given at construction.
+     */
+    double BoxSum(int x, int y, int radius) const {
+        // Table index of padded cell (i, j) is (i + 1, j + 1); the cell (x, y) is padded (x + border, y + border)
+        const int x0 = x + border - radius;
+        const int x1 = x + border + radius + 1;
+        const int y0 = y + border - radius;
+        const int y1 = y + border + radius + 1;
+        return At(x1, y1) - At(x0, y1) - At(x1, y0) + At(x0, y0);
+    }
+
+    /**
+     * @brief The sum of every padded cell with index below (i, j).
+     */
+    double At(int i, int j) const {
+        return table[size_t(i) * tableH + j];
+    }
+};
+
+#endif
@@ -0,0 +1,250 @@
+// File: Termination.hpp
+// Created on: October 18th, 2026
+
+// Early-termination criteria for long runs. The stepping kernels fold a few
+// statistics of each new generation into a GridStats as they write it, and
+// a TerminationMonitor decides from those alone whether the run has become
+// uninformative (died out, filled up, stopped changing or started cycling).
+
+#ifndef TERMINATION_HPP
+#define TERMINATION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+/**
+ * @brief Statistics of one generation, accumulated cell by cell.
+ *
+ * Every field combines with Merge in any order, so each thread can fill its
+ * own GridStats for its share of the grid and the results can be merged.
+ */
+struct GridStats {
+    size_t cells = 0;        // Cells accumulated
+    size_t alive = 0;        // Cells with a nonzero state
+    double sum = 0;          // Total of all states
+    float maxChange = 0;     // Largest change of any cell since the previous generation
+    double totalChange = 0;  // Sum of every cell's change since the previous generation
+    bool hasChange = true;   // Whether maxChange was measured; false when only the new grid was seen
+    uint64_t hash = 0;       // Order-independent hash of the exact grid contents
+
+    /**
+     * @brief Adds one cell of the new generation.
+     *
+     * @param index The cell's index, so identical states in different places hash differently.
+     * @param before The cell's state in the previous generation.
+     * @param after The cell's new state.
+     */
+    void Add(size_t index, float before, float after) {
+        AddState(index, after);
+        const float change = after > before ? after - before : before - after;
+        maxChange = std::max(maxChange, change);
+        totalChange += change;
+    }
+
+    /**
+     * @brief Adds one cell when the previous generation isn't available.
+     */
+    void AddState(size_t index, float state) {
+        cells++;
+        alive += state != 0;
+        sum += state;
+        uint32_t bits;
+        std::memcpy(&bits, &state, sizeof(bits));
+        hash += Mix(index * 0x9E3779B97F4A7C15ull + bits);
+    }
+
+    void Merge(const GridStats & other) {
+        cells += other.cells;
+        alive += other.alive;
+        sum += other.sum;
+        maxChange = std::max(maxChange, other.maxChange);
+        totalChange += other.totalChange;
+        hasChange = hasChange && other.hasChange;
+        hash += other.hash;
+    }
+
+    // SplitMix64 finalizer
+    static uint64_t Mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
+/**
+ * @brief Which criteria end a run early; everything is off by default.
+ */
+struct TerminationCriteria {
+    bool extinction = false;           // Stop once no cell is alive
+    double saturation = 0;             // Stop once at least this fraction of cells is alive (0 disables)
+    float fixedPointTolerance = 0;     // A generation counts as unchanged if no cell moved more than this
+    int fixedPointGenerations = 0;     // Stop after this many unchanged generations in a row (0 disables)
+    int maxCyclePeriod = 0;            // Stop when the grid repeats with a period up to this (0 disables)
+    double minPopulation = 0;          // Stop when the live fraction falls below this...
+    double maxPopulation = 1;          // ...or rises above this
+    size_t populationGraceGenerations = 0; // Generations before the population band applies
+
+    bool Any() const {
+        return extinction || saturation > 0 || fixedPointGenerations > 0 || maxCyclePeriod > 0 ||
+               minPopulation > 0 || maxPopulation < 1;
+    }
+};
+
+/**
+ * @brief The criteria used when early stopping is simply switched on.
+ *
+ * Stops on extinction, on every cell being alive, after 5 generations in a
+ * row in which no cell moved more than 1e-6, and on cycles of up to 16.
+ */
+inline TerminationCriteria DefaultTerminationCriteria() {
+    TerminationCriteria criteria;
+    criteria.extinction = true;
+    criteria.saturation = 1;
+    criteria.fixedPointTolerance = 1e-6f;
+    criteria.fixedPointGenerations = 5;
+    criteria.maxCyclePeriod = 16;
+    return criteria;
+}
+
+/**
+ * @brief Why a run was stopped early.
+ */
+enum class TerminationReason { None, Extinction, Saturation, FixedPoint, Cycle, PopulationBand };
+
+inline const char * DescribeTermination(TerminationReason reason) {
+    switch (reason) {
+        case TerminationReason::Extinction: return "extinction";
+        case TerminationReason::Saturation: return "saturation";
+        case TerminationReason::FixedPoint: return "fixed point";
+        case TerminationReason::Cycle: return "cycle";
+        case TerminationReason::PopulationBand: return "population out of band";
+        default: return "none";
+    }
+}
+
+/**
+ * @brief Checks each generation's statistics against a set of criteria.
+ *
+ * Cycles are found by comparing grid hashes with those of the last
+ * maxCyclePeriod generations, so detection costs nothing per cell beyond
+ * the hash already in GridStats. A period of 1 is a fixed point, and is
+ * reported as one.
+ */
+class TerminationMonitor {
+
+    TerminationCriteria criteria;
+    std::vector<uint64_t> recentHashes; // Ring of the last maxCyclePeriod hashes
+    uint64_t lastHash = 0;              // Hash of the previous generation
+    size_t seen = 0;                    // Generations checked since the last reset
+    int unchangedRun = 0;               // Consecutive generations within the fixed-point tolerance
+
+    public:
+
+    TerminationMonitor() = default;
+
+    explicit TerminationMonitor(const TerminationCriteria & settings) { SetCriteria(settings); }
+
+    void SetCriteria(const TerminationCriteria & settings) {
+        criteria = settings;
+        recentHashes.assign(size_t(std::max(criteria.maxCyclePeriod, 0)), 0);
+        Reset();
+    }
+
+    const TerminationCriteria & GetCriteria() const { return criteria; }
+
+    /**
+     * @brief Forgets the run so far; call after the grid is edited or reseeded.
+     */
+    void Reset() {
+        seen = 0;
+        unchangedRun = 0;
+    }
+
+    /**
+     * @brief Writes what the monitor remembers of the run, for checkpoints.
+     *
+     * The criteria aren't included; a restored monitor must be given the same ones.
+     */
+    void SaveState(std::ostream & out) const {
+        const uint64_t header[4] = { uint64_t(recentHashes.size()), lastHash, uint64_t(seen), uint64_t(unchangedRun) };
+        out.write(reinterpret_cast<const char *>(header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(recentHashes.data()), std::streamsize(recentHashes.size() * sizeof(uint64_t)));
+    }
+
+    /**
+     * @brief Restores the state written by SaveState.
+     *
+     * @return False, leaving the monitor unchanged, if the data is truncated or was saved with another cycle period.
+     */
+    bool LoadState(std::istream & in) {
+        uint64_t header[4];
+        if (!in.read(reinterpret_cast<char *>(header), sizeof(header)) || header[0] != recentHashes.size()) {
+            return false;
+        }
+        std::vector<uint64_t> hashes(recentHashes.size());
+        if (!in.read(reinterpret_cast<char *>(hashes.data()), std::streamsize(hashes.size() * sizeof(uint64_t)))) {
+            return false;
+        }
+        recentHashes.swap(hashes);
+        lastHash = header[1];
+        seen = size_t(header[2]);
+        unchangedRun = int(header[3]);
+        return true;
+    }
+
+    /**
+     * @brief Checks one generation.
+     *
+     * @param stats The statistics of the generation just computed.
+     * @param generation Its generation number, for the population band's grace period.
+     * @return The first criterion met, or None to keep running.
+     */
+    TerminationReason Check(const GridStats & stats, size_t generation) {
+        const double liveFraction = stats.cells ? double(stats.alive) / stats.cells : 0;
+
+        // Fixed point: measured directly, or inferred from an identical hash
+        bool unchanged = stats.hasChange ? stats.maxChange <= criteria.fixedPointTolerance
+                                         : seen > 0 && lastHash == stats.hash;
+        unchangedRun = unchanged ? unchangedRun + 1 : 0;
+
+        // Look for this grid among the recent ones before remembering it
+        int period = 0;
+        const size_t ring = recentHashes.size();
+        for (size_t p = 1; p <= std::min(ring, seen); p++) {
+            if (recentHashes[(seen - p) % ring] == stats.hash) {
+                period = int(p);
+                break;
+            }
+        }
+        if (ring > 0) {
+            recentHashes[seen % ring] = stats.hash;
+        }
+        lastHash = stats.hash;
+        seen++;
+
+        if (criteria.extinction && stats.alive == 0) {
+            return TerminationReason::Extinction;
+        }
+        if (criteria.saturation > 0 && liveFraction >= criteria.saturation) {
+            return TerminationReason::Saturation;
+        }
+        if (criteria.fixedPointGenerations > 0 && unchangedRun >= criteria.fixedPointGenerations) {
+            return TerminationReason::FixedPoint;
+        }
+        if (period > 0) {
+            return period == 1 ? TerminationReason::FixedPoint : TerminationReason::Cycle;
+        }
+        if (generation >= criteria.populationGraceGenerations &&
+            (liveFraction < criteria.minPopulation || liveFraction > criteria.maxPopulation)) {
+            return TerminationReason::PopulationBand;
+        }
+        return TerminationReason::None;
+    }
+};
+
+#endif
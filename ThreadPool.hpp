@@ -0,0 +1,122 @@
+// File: ThreadPool.hpp
+// Created on: October 18th, 2026
+
+// A small pool of reusable threads for splitting loops over the grid.
+// Shared by the 2D animator and the 3D volume engine.
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A fixed set of threads that split loops over a range between them.
+ * 
+ * The threads are created once and reused for every call, so a generation
+ * can be parallelized without paying thread startup costs each time. With a
+ * size of 1 no threads are created and loops simply run on the caller.
+ */
+class ThreadPool {
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake; // Signals workers that a new job is ready
+    std::condition_variable done; // Signals the caller that all chunks finished
+    std::function<void(int, int)> job;
+    int jobBegin = 0;
+    int jobEnd = 0;
+    size_t jobId = 0;  // Incremented for every job so workers don't run one twice
+    int remaining = 0; // Worker chunks of the current job still running
+    bool quit = false;
+
+    public:
+
+    explicit ThreadPool(int numThreads) {
+        for (int t = 1; t < numThreads; t++) {
+            workers.emplace_back([this, t]() { WorkerLoop(t); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wake.notify_all();
+        for (auto & worker : workers) {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Total number of threads, including the calling thread.
+     */
+    int Size() const { return int(workers.size()) + 1; }
+
+    /**
+     * @brief Runs fn over [begin, end), split into one contiguous chunk per thread.
+     * 
+     * The caller processes the first chunk itself and returns once every
+     * chunk has finished.
+     * 
+     * @param begin The first index of the range.
+     * @param end One past the last index of the range.
+     * @param fn Called as fn(chunkBegin, chunkEnd) for each chunk.
+     */
+    void ParallelFor(int begin, int end, const std::function<void(int, int)> & fn) {
+        if (workers.empty() || end - begin < 2) {
+            fn(begin, end);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = fn;
+            jobBegin = begin;
+            jobEnd = end;
+            remaining = int(workers.size());
+            jobId++;
+        }
+        wake.notify_all();
+
+        auto [chunkBegin, chunkEnd] = Chunk(0);
+        fn(chunkBegin, chunkEnd);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]() { return remaining == 0; });
+    }
+
+    private:
+
+    std::pair<int, int> Chunk(int index) const {
+        int length = jobEnd - jobBegin;
+        return { jobBegin + length * index / Size(), jobBegin + length * (index + 1) / Size() };
+    }
+
+    void WorkerLoop(int index) {
+        size_t seenJob = 0;
+        while (true) {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&]() { return quit || jobId != seenJob; });
+            if (quit) {
+                return;
+            }
+            seenJob = jobId;
+            auto [chunkBegin, chunkEnd] = Chunk(index);
+            lock.unlock();
+
+            job(chunkBegin, chunkEnd);
+
+            lock.lock();
+            if (--remaining == 0) {
+                done.notify_one();
+            }
+        }
+    }
+};
+
+#endif
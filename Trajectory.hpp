@@ -0,0 +1,425 @@
+// File: Trajectory.hpp
+// Created on: October 18th, 2026
+
+// An on-disk format for recorded runs that can be read a piece at a time.
+// Frames are grouped into blocks of consecutive frames, and each block is
+// cut into spatial tiles; one (block, tile) chunk is stored contiguously and
+// an index at the end of the file locates every chunk. A reader fetching a
+// rectangle over a range of frames reads only the chunks that overlap it.
+//
+// Layout, all integers uint64 and all values float in native byte order:
+//   header:  "CATRAJ1" magic (8 bytes), width, height, tile width, tile height,
+//            frames per block, frame count, index offset
+//   chunks:  block by block, tiles column by column; a chunk holds its
+//            frames in order, each frame its tile's cells indexed x * tile height + y
+//   index:   the generation of every frame, then the offset of every chunk
+//            in the order the chunks were written
+
+#ifndef TRAJECTORY_HPP
+#define TRAJECTORY_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief The fixed-size header at the start of a trajectory file.
+ */
+struct TrajectoryHeader {
+    char magic[8] = {'C', 'A', 'T', 'R', 'A', 'J', '1', '\0'};
+    uint64_t width = 0;
+    uint64_t height = 0;
+    uint64_t tileWidth = 0;
+    uint64_t tileHeight = 0;
+    uint64_t blockFrames = 0; // Frames per time block
+    uint64_t frames = 0;      // Frames recorded
+    uint64_t indexOffset = 0; // Where the index starts; 0 while the file is being written
+
+    uint64_t TilesX() const { return (width + tileWidth - 1) / tileWidth; }
+    uint64_t TilesY() const { return (height + tileHeight - 1) / tileHeight; }
+    uint64_t Blocks() const { return (frames + blockFrames - 1) / blockFrames; }
+};
+
+/**
+ * @brief Records frames of a grid into a trajectory file.
+ *
+ * A block of frames is buffered in memory and written out as chunks once it
+ * is full. The file is written under a temporary name and renamed into place
+ * by Close, so a run that dies half way never leaves a truncated file that
+ * looks complete.
+ */
+class TrajectoryWriter {
+
+    TrajectoryHeader header;
+    std::string path;
+    std::string temporary;
+    int fd = -1;
+    uint64_t offset = 0;                // Where the next chunk goes
+    std::vector<float> block;           // The buffered frames of the current block
+    uint64_t blockCount = 0;            // Frames buffered in it
+    std::vector<uint64_t> generations;  // Generation of every frame
+    std::vector<uint64_t> chunkOffsets; // Offset of every chunk written
+    bool failed = false;
+
+    public:
+
+    /**
+     * @brief Creates the file; check IsOpen() before appending.
+     *
+     * @param filePath Where the finished trajectory goes.
+     * @param width, height The grid's size.
+     * @param tileWidth, tileHeight The size of a chunk's spatial tile.
+     * @param blockFrames The number of frames in a chunk.
+     */
+    TrajectoryWriter(const std::string & filePath, int width, int height, int tileWidth, int tileHeight, int blockFrames)
+        : path(filePath), temporary(filePath + ".tmp") {
+        header.width = uint64_t(std::max(width, 1));
+        header.height = uint64_t(std::max(height, 1));
+        header.tileWidth = uint64_t(std::clamp(tileWidth, 1, int(header.width)));
+        header.tileHeight = uint64_t(std::clamp(tileHeight, 1, int(header.height)));
+        header.blockFrames = uint64_t(std::max(blockFrames, 1));
+        block.resize(header.blockFrames * header.width * header.height);
+
+        fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        // The header is rewritten with the final counts by Close
+        failed = fd < 0 || !WriteAll(&header, sizeof(header));
+        offset = sizeof(header);
+    }
+
+    ~TrajectoryWriter() {
+        if (fd >= 0) {
+            // Never closed: the recording is incomplete, so don't keep it
+            close(fd);
+            unlink(temporary.c_str());
+        }
+    }
+
+    bool IsOpen() const { return fd >= 0 && !failed; }
+
+    /**
+     * @brief Appends one frame, a grid indexed x * height + y.
+     */
+    bool Append(const float * cells, uint64_t generation) {
+        if (!IsOpen()) {
+            return false;
+        }
+        const size_t frameSize = size_t(header.width * header.height);
+        std::copy(cells, cells + frameSize, block.begin() + std::ptrdiff_t(blockCount * frameSize));
+        generations.push_back(generation);
+        if (++blockCount == header.blockFrames) {
+            FlushBlock();
+        }
+        return IsOpen();
+    }
+
+    /**
+     * @brief Writes the last partial block and the index, and moves the file into place.
+     *
+     * @return False if any write failed, in which case no file is left behind.
+     */
+    bool Close() {
+        if (fd < 0) {
+            return false;
+        }
+        if (blockCount > 0) {
+            FlushBlock();
+        }
+        header.frames = generations.size();
+        header.indexOffset = offset;
+        bool ok = IsOpen() && WriteAll(generations.data(), generations.size() * sizeof(uint64_t)) &&
+                  WriteAll(chunkOffsets.data(), chunkOffsets.size() * sizeof(uint64_t)) &&
+                  pwrite(fd, &header, sizeof(header), 0) == ssize_t(sizeof(header)) && fsync(fd) == 0;
+        ok = close(fd) == 0 && ok;
+        fd = -1;
+        if (!ok || rename(temporary.c_str(), path.c_str()) != 0) {
+            unlink(temporary.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    private:
+
+    /**
+     * @brief Writes the buffered frames as one chunk per tile.
+     */
+    void FlushBlock() {
+        const uint64_t h = header.height;
+        const size_t frameSize = size_t(header.width * h);
+        std::vector<float> chunk;
+        for (uint64_t tx = 0; tx < header.TilesX(); tx++) {
+            const uint64_t x0 = tx * header.tileWidth;
+            const uint64_t x1 = std::min(x0 + header.tileWidth, header.width);
+            for (uint64_t ty = 0; ty < header.TilesY(); ty++) {
+                const uint64_t y0 = ty * header.tileHeight;
+                const uint64_t y1 = std::min(y0 + header.tileHeight, h);
+                chunk.clear();
+                for (uint64_t f = 0; f < blockCount; f++) {
+                    const float * frame = block.data() + f * frameSize;
+                    for (uint64_t x = x0; x < x1; x++) {
+                        chunk.insert(chunk.end(), frame + x * h + y0, frame + x * h + y1);
+                    }
+                }
+                chunkOffsets.push_back(offset);
+                failed = failed || !WriteAll(chunk.data(), chunk.size() * sizeof(float));
+                offset += chunk.size() * sizeof(float);
+            }
+        }
+        blockCount = 0;
+    }
+
+    bool WriteAll(const void * data, size_t bytes) {
+        const char * next = static_cast<const char *>(data);
+        while (bytes > 0) {
+            const ssize_t n = write(fd, next, bytes);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            next += n;
+            bytes -= size_t(n);
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Reads rectangles over ranges of frames from a trajectory file.
+ *
+ * Only the index is loaded when the file is opened. Chunks are read with
+ * pread as they are needed, or, when the file is memory-mapped, copied
+ * straight from the mapping and paged in by the kernel.
+ */
+class TrajectoryReader {
+
+    TrajectoryHeader header;
+    int fd = -1;
+    const char * mapping = nullptr; // The whole file, when memory-mapped
+    size_t fileSize = 0;
+    std::vector<uint64_t> generations;
+    std::vector<uint64_t> chunkOffsets;
+    std::vector<float> scratch; // One chunk's frames, when reading with pread
+    uint64_t bytesRead = 0;
+
+    public:
+
+    /**
+     * @brief Opens a finished trajectory; check IsOpen() before reading.
+     *
+     * @param path The file.
+     * @param useMmap Map the file instead of reading it with pread.
+     */
+    explicit TrajectoryReader(const std::string & path, bool useMmap = false) {
+        fd = open(path.c_str(), O_RDONLY);
+        struct stat info;
+        if (fd < 0 || fstat(fd, &info) != 0 || !ReadAt(&header, sizeof(header), 0) ||
+            std::memcmp(header.magic, TrajectoryHeader().magic, sizeof(header.magic)) != 0 ||
+            header.indexOffset == 0 || header.tileWidth == 0 || header.tileHeight == 0 || header.blockFrames == 0) {
+            Close();
+            return;
+        }
+        fileSize = size_t(info.st_size);
+        // A corrupt header must not make the index huge, so check it fits in the file first
+        const uint64_t indexEntries = header.indexOffset <= fileSize ? (fileSize - header.indexOffset) / sizeof(uint64_t) : 0;
+        const uint64_t tiles = header.TilesX() * header.TilesY();
+        // The writer clamps tiles to the grid, so larger ones (which would also
+        // wrap the tile counts around) can only come from a corrupt header
+        if (header.width > INT32_MAX || header.height > INT32_MAX || header.tileWidth > header.width ||
+            header.tileHeight > header.height || header.blockFrames > INT32_MAX || header.frames > indexEntries ||
+            (tiles > 0 && header.Blocks() > (indexEntries - header.frames) / tiles) || !ChunkSizeFits()) {
+            Close();
+            return;
+        }
+        generations.resize(header.frames);
+        chunkOffsets.resize(header.Blocks() * header.TilesX() * header.TilesY());
+        const uint64_t offsetsAt = header.indexOffset + generations.size() * sizeof(uint64_t);
+        if (offsetsAt + chunkOffsets.size() * sizeof(uint64_t) != fileSize ||
+            !ReadAt(generations.data(), generations.size() * sizeof(uint64_t), header.indexOffset) ||
+            !ReadAt(chunkOffsets.data(), chunkOffsets.size() * sizeof(uint64_t), offsetsAt) ||
+            !ChunksInBounds()) {
+            Close();
+            return;
+        }
+        if (useMmap) {
+            void * mapped = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+            if (mapped != MAP_FAILED) {
+                mapping = static_cast<const char *>(mapped);
+            }
+        }
+    }
+
+    ~TrajectoryReader() {
+        Close();
+    }
+
+    TrajectoryReader(const TrajectoryReader &) = delete;
+    TrajectoryReader & operator=(const TrajectoryReader &) = delete;
+
+    bool IsOpen() const { return fd >= 0; }
+    int GetWidth() const { return int(header.width); }
+    int GetHeight() const { return int(header.height); }
+    size_t Frames() const { return generations.size(); }
+    uint64_t Generation(size_t frame) const { return generations[frame]; }
+    size_t FileSize() const { return fileSize; }
+
+    /**
+     * @brief Bytes of chunk data fetched so far (with pread) or touched (with mmap).
+     */
+    uint64_t BytesRead() const { return bytesRead; }
+
+    /**
+     * @brief The first frame recorded at or after a generation (Frames() if none).
+     */
+    size_t FrameAtOrAfter(uint64_t generation) const {
+        return size_t(std::lower_bound(generations.begin(), generations.end(), generation) - generations.begin());
+    }
+
+    /**
+     * @brief Reads a rectangle of cells over a range of frames.
+     *
+     * @param x, y, width, height The rectangle; it must lie inside the grid.
+     * @param firstFrame, frameCount The frames to read.
+     * @param out Receives frameCount frames of width * height values, each
+     * indexed (column - x) * height + (row - y) like the grid.
+     * @return False if the request is out of range or a read failed.
+     */
+    bool Read(int x, int y, int width, int height, size_t firstFrame, size_t frameCount, float * out) {
+        if (!IsOpen() || x < 0 || y < 0 || width < 0 || height < 0 || uint64_t(x) + width > header.width ||
+            uint64_t(y) + height > header.height || firstFrame + frameCount > generations.size()) {
+            return false;
+        }
+        if (width == 0 || height == 0 || frameCount == 0) {
+            return true;
+        }
+        const uint64_t rx0 = uint64_t(x), rx1 = rx0 + uint64_t(width);
+        const uint64_t ry0 = uint64_t(y), ry1 = ry0 + uint64_t(height);
+        const size_t outFrame = size_t(width) * height;
+
+        for (uint64_t b = firstFrame / header.blockFrames; b * header.blockFrames < firstFrame + frameCount; b++) {
+            const uint64_t blockStart = b * header.blockFrames;
+            const uint64_t f0 = std::max<uint64_t>(firstFrame, blockStart);
+            const uint64_t f1 = std::min<uint64_t>({firstFrame + frameCount, blockStart + header.blockFrames, header.frames});
+
+            for (uint64_t tx = rx0 / header.tileWidth; tx * header.tileWidth < rx1; tx++) {
+                const uint64_t tileX0 = tx * header.tileWidth;
+                const uint64_t tileW = std::min(header.tileWidth, header.width - tileX0);
+                for (uint64_t ty = ry0 / header.tileHeight; ty * header.tileHeight < ry1; ty++) {
+                    const uint64_t tileY0 = ty * header.tileHeight;
+                    const uint64_t tileH = std::min(header.tileHeight, header.height - tileY0);
+                    const size_t tileSize = size_t(tileW * tileH);
+
+                    // The frames needed from this chunk are contiguous in it
+                    const uint64_t chunk = (b * header.TilesX() + tx) * header.TilesY() + ty;
+                    const uint64_t start = chunkOffsets[chunk] + (f0 - blockStart) * tileSize * sizeof(float);
+                    const size_t bytes = size_t(f1 - f0) * tileSize * sizeof(float);
+                    const float * data;
+                    if (mapping) {
+                        data = reinterpret_cast<const float *>(mapping + start);
+                    } else {
+                        scratch.resize(size_t(f1 - f0) * tileSize);
+                        if (!ReadAt(scratch.data(), bytes, start)) {
+                            return false;
+                        }
+                        data = scratch.data();
+                    }
+                    bytesRead += bytes;
+
+                    // Copy the overlap of the tile and the rectangle, column by column
+                    const uint64_t cx0 = std::max(rx0, tileX0), cx1 = std::min(rx1, tileX0 + tileW);
+                    const uint64_t cy0 = std::max(ry0, tileY0), cy1 = std::min(ry1, tileY0 + tileH);
+                    for (uint64_t f = f0; f < f1; f++) {
+                        const float * frame = data + (f - f0) * tileSize;
+                        float * target = out + (f - firstFrame) * outFrame;
+                        for (uint64_t cx = cx0; cx < cx1; cx++) {
+                            const float * column = frame + (cx - tileX0) * tileH;
+                            std::copy(column + (cy0 - tileY0), column + (cy1 - tileY0),
+                                      target + (cx - rx0) * uint64_t(height) + (cy0 - ry0));
+                        }
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    private:
+
+    /**
+     * @brief Checks by division that the largest chunk the header describes fits in the file.
+     *
+     * Chunk sizes are multiplied out later, and a tile of nearly 2^31 x 2^31
+     * cells would wrap that product around 64 bits. Runs after the tiles are
+     * checked to be no larger than the INT32_MAX-bounded grid, so the tile
+     * area itself can't overflow.
+     */
+    bool ChunkSizeFits() const {
+        const uint64_t frames = std::min<uint64_t>(header.blockFrames, header.frames);
+        const uint64_t tileArea = header.tileWidth * header.tileHeight;
+        return frames == 0 || tileArea <= (fileSize / sizeof(float)) / frames;
+    }
+
+    /**
+     * @brief Whether every chunk lies whole between the header and the index.
+     *
+     * Checked once at open, so Read can trust the offsets, even reading
+     * straight from the mapping.
+     */
+    bool ChunksInBounds() const {
+        for (uint64_t b = 0; b < header.Blocks(); b++) {
+            const uint64_t frames = std::min<uint64_t>(header.blockFrames, header.frames - b * header.blockFrames);
+            for (uint64_t tx = 0; tx < header.TilesX(); tx++) {
+                const uint64_t tileW = std::min(header.tileWidth, header.width - tx * header.tileWidth);
+                for (uint64_t ty = 0; ty < header.TilesY(); ty++) {
+                    const uint64_t tileH = std::min(header.tileHeight, header.height - ty * header.tileHeight);
+                    const uint64_t offset = chunkOffsets[(b * header.TilesX() + tx) * header.TilesY() + ty];
+                    const uint64_t bytes = frames * tileW * tileH * sizeof(float);
+                    if (offset < sizeof(header) || offset > header.indexOffset || bytes > header.indexOffset - offset) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    void Close() {
+        if (mapping) {
+            munmap(const_cast<char *>(mapping), fileSize);
+            mapping = nullptr;
+        }
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    bool ReadAt(void * data, size_t bytes, uint64_t offset) {
+        char * next = static_cast<char *>(data);
+        while (bytes > 0) {
+            const ssize_t n = pread(fd, next, bytes, off_t(offset));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            next += n;
+            bytes -= size_t(n);
+            offset += uint64_t(n);
+        }
+        return true;
+    }
+};
+
+#endif
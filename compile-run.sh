@@ -1,2 +1,98 @@
-emcc -std=c++17 -IEmpirical/include/ -Os --js-library Empirical/include/emp/web/library_emp.js -s EXPORTED_FUNCTIONS="['_main', '_empCppCallback', '_empDoCppCallback']" -s "EXTRA_EXPORTED_RUNTIME_METHODS=['ccall', 'cwrap']" -s NO_EXIT_RUNTIME=1 CAAnimate.cpp -o CAAnimate.js
-python3 -m http.server
\ No newline at end of file
+# Build settings; override from the environment, e.g. GRID_W=1000 GRID_H=1000 ./compile-run.sh
+GRID_W=${GRID_W:-100}
+GRID_H=${GRID_H:-100}
+GRID_D=${GRID_D:-1}
+HISTORY=${HISTORY:-0}
+HISTORY_MB=${HISTORY_MB:-0}
+PIXEL=${PIXEL:-0}
+WORKER=${WORKER:-0}
+HIDDEN_STEP_HZ=${HIDDEN_STEP_HZ:-0}
+THREADS=${THREADS:-1}
+PARAM_TILE=${PARAM_TILE:-0}
+UPDATE_MODE=${UPDATE_MODE:-0}
+NOISE=${NOISE:-0}
+NOISE_SKIP=${NOISE_SKIP:-0}
+NOISE_SEED=${NOISE_SEED:-0}
+HALF=${HALF:-0}
+HALF_REPORT=${HALF_REPORT:-0}
+SPARSE=${SPARSE:-0}
+DEDUP=${DEDUP:-0}
+SAT=${SAT:-0}
+EARLY_STOP=${EARLY_STOP:-0}
+SPECTRUM=${SPECTRUM:-0}
+
+# The worker build renders through the pixel buffer; it, THREADS > 1 and the spectral
+# analysis need pthreads, with every thread created up front (the pool's extra threads,
+# the worker and the analysis thread)
+ANALYSIS_THREADS=$(( SPECTRUM > 0 ? 1 : 0 ))
+THREAD_FLAGS=""
+if [ "$WORKER" = 1 ] || [ "$THREADS" -gt 1 ] || [ "$ANALYSIS_THREADS" = 1 ]; then
+    THREAD_FLAGS="-pthread -s PTHREAD_POOL_SIZE=$(( THREADS - 1 + WORKER + ANALYSIS_THREADS ))"
+fi
+if [ "$WORKER" = 1 ]; then
+    PIXEL=1
+    THREAD_FLAGS="$THREAD_FLAGS -s OFFSCREENCANVAS_SUPPORT=1"
+fi
+
+# Size the WASM heap up front: current + next generation + history ring + pixel buffer (4 bytes per cell),
+# plus 16 MiB for the runtime and Empirical, rounded up to whole 64 KiB pages.
+# Memory growth is disabled so the heap is never copied while the animation runs.
+# (the asynchronous update modes work in place and have no next generation buffer;
+# half-precision storage replaces it with two 2-byte grids, the same total)
+GRID_BUFFERS=$(( UPDATE_MODE == 0 ? 2 : 1 ))
+if [ "$SPARSE" = 1 ]; then
+    # Sparse tiles take almost nothing on sparse fields, but reserve room for
+    # the worst case of every tile turning dense in both tile sets
+    GRID_BUFFERS=3
+fi
+if [ "$DEDUP" = 1 ]; then
+    # Shared tiles take little on sparse or periodic fields, but reserve room for every
+    # tile being distinct in the current and next generation and in remembered results
+    GRID_BUFFERS=4
+fi
+SIM_BYTES=$(( GRID_W * GRID_H * 4 * (GRID_BUFFERS + HISTORY + PIXEL) ))
+if [ "$GRID_D" -gt 1 ]; then
+    # The 3D volume: current and next generation plus the two cube sum buffers
+    SIM_BYTES=$(( SIM_BYTES + GRID_W * GRID_H * GRID_D * 4 * 4 ))
+fi
+if [ "$SAT" = 1 ]; then
+    # The summed-area table: one double per cell of the grid plus its 3-cell wrapped border
+    SIM_BYTES=$(( SIM_BYTES + (GRID_W + 7) * (GRID_H + 7) * 8 ))
+fi
+if [ "$SPECTRUM" -gt 0 ]; then
+    # The analysis snapshot (4 bytes per cell) and its complex transform (16 bytes per cell)
+    SIM_BYTES=$(( SIM_BYTES + GRID_W * GRID_H * 20 ))
+fi
+if [ "$HISTORY_MB" -gt 0 ]; then
+    # The compressed history budget, an eighth more for its frame descriptions, and
+    # its scratch buffers (about 16 bytes per cell, including the frame being scrubbed to)
+    SIM_BYTES=$(( SIM_BYTES + HISTORY_MB * 1024 * 1024 * 9 / 8 + GRID_W * GRID_H * 16 ))
+fi
+if [ "$PARAM_TILE" -gt 0 ]; then
+    # Four rule parameter planes with one float per tile
+    TILES=$(( ((GRID_W + PARAM_TILE - 1) / PARAM_TILE) * ((GRID_H + PARAM_TILE - 1) / PARAM_TILE) ))
+    SIM_BYTES=$(( SIM_BYTES + TILES * 4 * 4 ))
+fi
+# The half-precision conversions are branch-free so their row loops vectorize with WASM SIMD
+SIMD_FLAGS=""
+if [ "$HALF" = 1 ]; then
+    SIMD_FLAGS="-msimd128"
+fi
+
+INITIAL_MEMORY=$(( (SIM_BYTES + 16 * 1024 * 1024 + 65535) / 65536 * 65536 ))
+
+emcc -std=c++17 -IEmpirical/include/ -Os --js-library Empirical/include/emp/web/library_emp.js -s EXPORTED_FUNCTIONS="['_main', '_empCppCallback', '_empDoCppCallback']" -s "EXTRA_EXPORTED_RUNTIME_METHODS=['ccall', 'cwrap']" -s NO_EXIT_RUNTIME=1 -s INITIAL_MEMORY=$INITIAL_MEMORY -s ALLOW_MEMORY_GROWTH=0 -DCA_GRID_W=$GRID_W -DCA_GRID_H=$GRID_H -DCA_GRID_D=$GRID_D -DCA_HISTORY_FRAMES=$HISTORY -DCA_COMPRESSED_HISTORY_MB=$HISTORY_MB -DCA_PIXEL_RENDER=$PIXEL -DCA_WORKER=$WORKER -DCA_HIDDEN_STEP_HZ=$HIDDEN_STEP_HZ -DCA_THREADS=$THREADS -DCA_PARAM_TILE=$PARAM_TILE -DCA_UPDATE_MODE=$UPDATE_MODE -DCA_NOISE_AMPLITUDE=$NOISE -DCA_NOISE_SKIP=$NOISE_SKIP -DCA_NOISE_SEED=$NOISE_SEED -DCA_HALF_STORAGE=$HALF -DCA_HALF_REPORT=$HALF_REPORT -DCA_SPARSE_STORAGE=$SPARSE -DCA_DEDUP_STORAGE=$DEDUP -DCA_SAT_NEIGHBORHOOD=$SAT -DCA_EARLY_STOP=$EARLY_STOP -DCA_SPECTRUM_INTERVAL=$SPECTRUM $THREAD_FLAGS $SIMD_FLAGS CAAnimate.cpp -o CAAnimate.js
+
+if [ -n "$THREAD_FLAGS" ]; then
+    # Shared WASM memory is only available on cross-origin isolated pages
+    python3 -c "
+import http.server
+class Handler(http.server.SimpleHTTPRequestHandler):
+    def end_headers(self):
+        self.send_header('Cross-Origin-Opener-Policy', 'same-origin')
+        self.send_header('Cross-Origin-Embedder-Policy', 'require-corp')
+        super().end_headers()
+http.server.test(Handler)"
+else
+    python3 -m http.server
+fi